@@ -0,0 +1,41 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/benchmarks.dir/benchmarks/bench_frontend.cpp.o"
+  "CMakeFiles/benchmarks.dir/benchmarks/bench_frontend.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/benchmarks/bench_interpreter.cpp.o"
+  "CMakeFiles/benchmarks.dir/benchmarks/bench_interpreter.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/benchmarks/bench_matrix.cpp.o"
+  "CMakeFiles/benchmarks.dir/benchmarks/bench_matrix.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Compiler.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Compiler.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/CsvReader.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/CsvReader.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Fusion.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Fusion.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Interpreter.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Interpreter.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Lexer.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Lexer.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/MappedFile.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/MappedFile.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/MatrixFile.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/MatrixFile.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Parser.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Parser.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Profiler.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Profiler.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Runner.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Runner.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Server.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Server.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Value.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Value.cpp.o.d"
+  "CMakeFiles/benchmarks.dir/src/Workspace.cpp.o"
+  "CMakeFiles/benchmarks.dir/src/Workspace.cpp.o.d"
+  "benchmarks"
+  "benchmarks.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/benchmarks.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
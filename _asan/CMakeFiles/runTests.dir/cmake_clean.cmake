@@ -0,0 +1,67 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/runTests.dir/src/Compiler.cpp.o"
+  "CMakeFiles/runTests.dir/src/Compiler.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/CsvReader.cpp.o"
+  "CMakeFiles/runTests.dir/src/CsvReader.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Fusion.cpp.o"
+  "CMakeFiles/runTests.dir/src/Fusion.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Interpreter.cpp.o"
+  "CMakeFiles/runTests.dir/src/Interpreter.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Lexer.cpp.o"
+  "CMakeFiles/runTests.dir/src/Lexer.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/MappedFile.cpp.o"
+  "CMakeFiles/runTests.dir/src/MappedFile.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/MatrixFile.cpp.o"
+  "CMakeFiles/runTests.dir/src/MatrixFile.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Parser.cpp.o"
+  "CMakeFiles/runTests.dir/src/Parser.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Profiler.cpp.o"
+  "CMakeFiles/runTests.dir/src/Profiler.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Runner.cpp.o"
+  "CMakeFiles/runTests.dir/src/Runner.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Server.cpp.o"
+  "CMakeFiles/runTests.dir/src/Server.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Value.cpp.o"
+  "CMakeFiles/runTests.dir/src/Value.cpp.o.d"
+  "CMakeFiles/runTests.dir/src/Workspace.cpp.o"
+  "CMakeFiles/runTests.dir/src/Workspace.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_compiler.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_compiler.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_csv_reader.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_csv_reader.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_fixed_matrix.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_fixed_matrix.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_interpreter.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_interpreter.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_lexer.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_lexer.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_main.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_main.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_matrix.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_matrix.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_matrix_file.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_matrix_file.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_parser.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_parser.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_profiler.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_profiler.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_runner.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_runner.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_server.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_server.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_simd.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_simd.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_sparse_matrix.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_sparse_matrix.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_thread_pool.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_thread_pool.cpp.o.d"
+  "CMakeFiles/runTests.dir/tests/test_workspace.cpp.o"
+  "CMakeFiles/runTests.dir/tests/test_workspace.cpp.o.d"
+  "runTests"
+  "runTests.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/runTests.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
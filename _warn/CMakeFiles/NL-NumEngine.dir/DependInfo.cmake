@@ -0,0 +1,32 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/main.cpp" "CMakeFiles/NL-NumEngine.dir/main.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/main.cpp.o.d"
+  "/root/repo/src/Compiler.cpp" "CMakeFiles/NL-NumEngine.dir/src/Compiler.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Compiler.cpp.o.d"
+  "/root/repo/src/CsvReader.cpp" "CMakeFiles/NL-NumEngine.dir/src/CsvReader.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/CsvReader.cpp.o.d"
+  "/root/repo/src/Fusion.cpp" "CMakeFiles/NL-NumEngine.dir/src/Fusion.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Fusion.cpp.o.d"
+  "/root/repo/src/Interpreter.cpp" "CMakeFiles/NL-NumEngine.dir/src/Interpreter.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Interpreter.cpp.o.d"
+  "/root/repo/src/Lexer.cpp" "CMakeFiles/NL-NumEngine.dir/src/Lexer.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Lexer.cpp.o.d"
+  "/root/repo/src/MappedFile.cpp" "CMakeFiles/NL-NumEngine.dir/src/MappedFile.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/MappedFile.cpp.o.d"
+  "/root/repo/src/MatrixFile.cpp" "CMakeFiles/NL-NumEngine.dir/src/MatrixFile.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/MatrixFile.cpp.o.d"
+  "/root/repo/src/Parser.cpp" "CMakeFiles/NL-NumEngine.dir/src/Parser.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Parser.cpp.o.d"
+  "/root/repo/src/Profiler.cpp" "CMakeFiles/NL-NumEngine.dir/src/Profiler.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Profiler.cpp.o.d"
+  "/root/repo/src/Runner.cpp" "CMakeFiles/NL-NumEngine.dir/src/Runner.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Runner.cpp.o.d"
+  "/root/repo/src/Server.cpp" "CMakeFiles/NL-NumEngine.dir/src/Server.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Server.cpp.o.d"
+  "/root/repo/src/Value.cpp" "CMakeFiles/NL-NumEngine.dir/src/Value.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Value.cpp.o.d"
+  "/root/repo/src/Workspace.cpp" "CMakeFiles/NL-NumEngine.dir/src/Workspace.cpp.o" "gcc" "CMakeFiles/NL-NumEngine.dir/src/Workspace.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
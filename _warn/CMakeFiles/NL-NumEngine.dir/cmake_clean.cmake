@@ -0,0 +1,37 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/NL-NumEngine.dir/main.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/main.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Compiler.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Compiler.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/CsvReader.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/CsvReader.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Fusion.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Fusion.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Interpreter.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Interpreter.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Lexer.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Lexer.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/MappedFile.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/MappedFile.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/MatrixFile.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/MatrixFile.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Parser.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Parser.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Profiler.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Profiler.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Runner.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Runner.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Server.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Server.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Value.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Value.cpp.o.d"
+  "CMakeFiles/NL-NumEngine.dir/src/Workspace.cpp.o"
+  "CMakeFiles/NL-NumEngine.dir/src/Workspace.cpp.o.d"
+  "NL-NumEngine"
+  "NL-NumEngine.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/NL-NumEngine.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
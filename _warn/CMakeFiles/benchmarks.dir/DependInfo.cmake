@@ -0,0 +1,34 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/benchmarks/bench_frontend.cpp" "CMakeFiles/benchmarks.dir/benchmarks/bench_frontend.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/benchmarks/bench_frontend.cpp.o.d"
+  "/root/repo/benchmarks/bench_interpreter.cpp" "CMakeFiles/benchmarks.dir/benchmarks/bench_interpreter.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/benchmarks/bench_interpreter.cpp.o.d"
+  "/root/repo/benchmarks/bench_matrix.cpp" "CMakeFiles/benchmarks.dir/benchmarks/bench_matrix.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/benchmarks/bench_matrix.cpp.o.d"
+  "/root/repo/src/Compiler.cpp" "CMakeFiles/benchmarks.dir/src/Compiler.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Compiler.cpp.o.d"
+  "/root/repo/src/CsvReader.cpp" "CMakeFiles/benchmarks.dir/src/CsvReader.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/CsvReader.cpp.o.d"
+  "/root/repo/src/Fusion.cpp" "CMakeFiles/benchmarks.dir/src/Fusion.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Fusion.cpp.o.d"
+  "/root/repo/src/Interpreter.cpp" "CMakeFiles/benchmarks.dir/src/Interpreter.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Interpreter.cpp.o.d"
+  "/root/repo/src/Lexer.cpp" "CMakeFiles/benchmarks.dir/src/Lexer.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Lexer.cpp.o.d"
+  "/root/repo/src/MappedFile.cpp" "CMakeFiles/benchmarks.dir/src/MappedFile.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/MappedFile.cpp.o.d"
+  "/root/repo/src/MatrixFile.cpp" "CMakeFiles/benchmarks.dir/src/MatrixFile.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/MatrixFile.cpp.o.d"
+  "/root/repo/src/Parser.cpp" "CMakeFiles/benchmarks.dir/src/Parser.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Parser.cpp.o.d"
+  "/root/repo/src/Profiler.cpp" "CMakeFiles/benchmarks.dir/src/Profiler.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Profiler.cpp.o.d"
+  "/root/repo/src/Runner.cpp" "CMakeFiles/benchmarks.dir/src/Runner.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Runner.cpp.o.d"
+  "/root/repo/src/Server.cpp" "CMakeFiles/benchmarks.dir/src/Server.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Server.cpp.o.d"
+  "/root/repo/src/Value.cpp" "CMakeFiles/benchmarks.dir/src/Value.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Value.cpp.o.d"
+  "/root/repo/src/Workspace.cpp" "CMakeFiles/benchmarks.dir/src/Workspace.cpp.o" "gcc" "CMakeFiles/benchmarks.dir/src/Workspace.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,47 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/src/Compiler.cpp" "CMakeFiles/runTests.dir/src/Compiler.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Compiler.cpp.o.d"
+  "/root/repo/src/CsvReader.cpp" "CMakeFiles/runTests.dir/src/CsvReader.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/CsvReader.cpp.o.d"
+  "/root/repo/src/Fusion.cpp" "CMakeFiles/runTests.dir/src/Fusion.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Fusion.cpp.o.d"
+  "/root/repo/src/Interpreter.cpp" "CMakeFiles/runTests.dir/src/Interpreter.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Interpreter.cpp.o.d"
+  "/root/repo/src/Lexer.cpp" "CMakeFiles/runTests.dir/src/Lexer.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Lexer.cpp.o.d"
+  "/root/repo/src/MappedFile.cpp" "CMakeFiles/runTests.dir/src/MappedFile.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/MappedFile.cpp.o.d"
+  "/root/repo/src/MatrixFile.cpp" "CMakeFiles/runTests.dir/src/MatrixFile.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/MatrixFile.cpp.o.d"
+  "/root/repo/src/Parser.cpp" "CMakeFiles/runTests.dir/src/Parser.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Parser.cpp.o.d"
+  "/root/repo/src/Profiler.cpp" "CMakeFiles/runTests.dir/src/Profiler.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Profiler.cpp.o.d"
+  "/root/repo/src/Runner.cpp" "CMakeFiles/runTests.dir/src/Runner.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Runner.cpp.o.d"
+  "/root/repo/src/Server.cpp" "CMakeFiles/runTests.dir/src/Server.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Server.cpp.o.d"
+  "/root/repo/src/Value.cpp" "CMakeFiles/runTests.dir/src/Value.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Value.cpp.o.d"
+  "/root/repo/src/Workspace.cpp" "CMakeFiles/runTests.dir/src/Workspace.cpp.o" "gcc" "CMakeFiles/runTests.dir/src/Workspace.cpp.o.d"
+  "/root/repo/tests/test_compiler.cpp" "CMakeFiles/runTests.dir/tests/test_compiler.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_compiler.cpp.o.d"
+  "/root/repo/tests/test_csv_reader.cpp" "CMakeFiles/runTests.dir/tests/test_csv_reader.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_csv_reader.cpp.o.d"
+  "/root/repo/tests/test_fixed_matrix.cpp" "CMakeFiles/runTests.dir/tests/test_fixed_matrix.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_fixed_matrix.cpp.o.d"
+  "/root/repo/tests/test_interpreter.cpp" "CMakeFiles/runTests.dir/tests/test_interpreter.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_interpreter.cpp.o.d"
+  "/root/repo/tests/test_lexer.cpp" "CMakeFiles/runTests.dir/tests/test_lexer.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_lexer.cpp.o.d"
+  "/root/repo/tests/test_main.cpp" "CMakeFiles/runTests.dir/tests/test_main.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_main.cpp.o.d"
+  "/root/repo/tests/test_matrix.cpp" "CMakeFiles/runTests.dir/tests/test_matrix.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_matrix.cpp.o.d"
+  "/root/repo/tests/test_matrix_file.cpp" "CMakeFiles/runTests.dir/tests/test_matrix_file.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_matrix_file.cpp.o.d"
+  "/root/repo/tests/test_parser.cpp" "CMakeFiles/runTests.dir/tests/test_parser.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_parser.cpp.o.d"
+  "/root/repo/tests/test_profiler.cpp" "CMakeFiles/runTests.dir/tests/test_profiler.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_profiler.cpp.o.d"
+  "/root/repo/tests/test_runner.cpp" "CMakeFiles/runTests.dir/tests/test_runner.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_runner.cpp.o.d"
+  "/root/repo/tests/test_server.cpp" "CMakeFiles/runTests.dir/tests/test_server.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_server.cpp.o.d"
+  "/root/repo/tests/test_simd.cpp" "CMakeFiles/runTests.dir/tests/test_simd.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_simd.cpp.o.d"
+  "/root/repo/tests/test_sparse_matrix.cpp" "CMakeFiles/runTests.dir/tests/test_sparse_matrix.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_sparse_matrix.cpp.o.d"
+  "/root/repo/tests/test_thread_pool.cpp" "CMakeFiles/runTests.dir/tests/test_thread_pool.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_thread_pool.cpp.o.d"
+  "/root/repo/tests/test_workspace.cpp" "CMakeFiles/runTests.dir/tests/test_workspace.cpp.o" "gcc" "CMakeFiles/runTests.dir/tests/test_workspace.cpp.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
@@ -0,0 +1,84 @@
+#include "Lexer.h"
+#include "Parser.h"
+#include <benchmark/benchmark.h>
+#include <string>
+
+namespace {
+
+/**
+ * @brief A rows x cols matrix literal, as typed in a script.
+ */
+auto matrixLiteral(size_t rows, size_t cols) -> std::string {
+  std::string source = "A = [";
+  for (size_t i = 0; i < rows; ++i) {
+    for (size_t j = 0; j < cols; ++j) {
+      source += std::to_string((i * cols + j) % 1000) + ".25";
+      source += j + 1 < cols ? ", " : "";
+    }
+    source += i + 1 < rows ? ";\n" : "]\n";
+  }
+  return source;
+}
+
+/**
+ * @brief A script of simple statements, one per line.
+ */
+auto statements(size_t count) -> std::string {
+  std::string source;
+  for (size_t i = 0; i < count; ++i) {
+    source += "X" + std::to_string(i % 10) + " = A * B + C - 2.5e-3 * D;\n";
+  }
+  return source;
+}
+
+void setBytes(benchmark::State &state, const std::string &source) {
+  state.counters["bytes"] = benchmark::Counter(
+      static_cast<double>(source.size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_LexStatements(benchmark::State &state) {
+  const std::string source = statements(static_cast<size_t>(state.range(0)));
+  for (auto _ : state) {
+    std::vector<Token> tokens = Lexer(source).scanProgram();
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  setBytes(state, source);
+}
+BENCHMARK(BM_LexStatements)->Arg(1000)->Arg(100000);
+
+void BM_LexMatrixLiteral(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const std::string source = matrixLiteral(n, n);
+  for (auto _ : state) {
+    std::vector<Token> tokens = Lexer(source).scanProgram();
+    benchmark::DoNotOptimize(tokens.data());
+  }
+  setBytes(state, source);
+}
+BENCHMARK(BM_LexMatrixLiteral)->Arg(100)->Arg(1000);
+
+void BM_ParseStatements(benchmark::State &state) {
+  const std::string source = statements(static_cast<size_t>(state.range(0)));
+  const std::vector<Token> tokens = Lexer(source).scanProgram();
+  for (auto _ : state) {
+    std::vector<Statement> program = Parser(tokens).parseProgram();
+    benchmark::DoNotOptimize(program.data());
+  }
+  setBytes(state, source);
+}
+BENCHMARK(BM_ParseStatements)->Arg(1000)->Arg(100000);
+
+void BM_ParseMatrixLiteral(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const std::string source = matrixLiteral(n, n);
+  const std::vector<Token> tokens = Lexer(source).scanProgram();
+  for (auto _ : state) {
+    std::vector<Statement> program = Parser(tokens).parseProgram();
+    benchmark::DoNotOptimize(program.data());
+  }
+  setBytes(state, source);
+}
+BENCHMARK(BM_ParseMatrixLiteral)->Arg(100)->Arg(1000);
+
+} // namespace
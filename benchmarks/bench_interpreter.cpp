@@ -0,0 +1,83 @@
+#include "Interpreter.h"
+#include "Runner.h"
+#include <benchmark/benchmark.h>
+#include <sstream>
+#include <string>
+
+namespace {
+
+/**
+ * @brief Statement assigning an n x n literal to name.
+ */
+auto literal(const std::string &name, int n) -> std::string {
+  std::string source = name + " = [";
+  for (int i = 0; i < n; ++i) {
+    for (int j = 0; j < n; ++j) {
+      source += std::to_string((i + j) % 7) + (j + 1 < n ? ", " : "");
+    }
+    source += i + 1 < n ? ";\n" : "];\n";
+  }
+  return source;
+}
+
+/**
+ * @brief Run a script end to end: lex, parse, compile and execute.
+ */
+void runScript(benchmark::State &state, const std::string &script) {
+  Interpreter interpreter;
+  std::ostringstream out;
+  std::ostringstream err;
+  Runner runner(interpreter, out, err);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(runner.run(script));
+    out.str({});
+  }
+  if (!err.str().empty()) {
+    state.SkipWithError(err.str().c_str());
+  }
+  state.counters["bytes"] = benchmark::Counter(
+      static_cast<double>(script.size()),
+      benchmark::Counter::kIsIterationInvariantRate);
+}
+
+// Many small statements: dominated by the front end and dispatch.
+void BM_ScalarScript(benchmark::State &state) {
+  std::string script = "x = 1;\n";
+  for (int i = 0; i < 1000; ++i) {
+    script += "x = x * 1.0001 + 0.5;\n";
+  }
+  runScript(state, script);
+}
+BENCHMARK(BM_ScalarScript);
+
+// Element-wise updates of mid-sized matrices: dominated by fused kernels.
+void BM_ElementwiseScript(benchmark::State &state) {
+  std::string script = literal("A", 32) + "B = A;\n";
+  for (int i = 0; i < 100; ++i) {
+    script += "B = B + A - A * 0.5;\nB *= 0.5;\n";
+  }
+  runScript(state, script);
+}
+BENCHMARK(BM_ElementwiseScript);
+
+// The same updates on float32 matrices: half the bytes per element.
+void BM_ElementwiseScriptSingle(benchmark::State &state) {
+  std::string script = literal("A", 32) + "A = single(A);\nB = A;\n";
+  for (int i = 0; i < 100; ++i) {
+    script += "B = B + A - A * 0.5;\nB *= 0.5;\n";
+  }
+  runScript(state, script);
+}
+BENCHMARK(BM_ElementwiseScriptSingle);
+
+// A few large products: dominated by GEMM.
+void BM_GemmScript(benchmark::State &state) {
+  const std::string script =
+      literal("A", 64) + "B = A * A;\nC = B * A + A;\nD = C * B;\n";
+  runScript(state, script);
+  state.counters["FLOP"] = benchmark::Counter(
+      3 * 2 * 64.0 * 64 * 64, benchmark::Counter::kIsIterationInvariantRate);
+}
+BENCHMARK(BM_GemmScript);
+
+} // namespace
@@ -0,0 +1,194 @@
+#include "FixedMatrix.h"
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include <benchmark/benchmark.h>
+
+namespace {
+
+/**
+ * @brief Matrix with deterministic, non-trivial contents.
+ */
+auto filled(size_t rows, size_t cols) -> Matrix<double> {
+  Matrix<double> matrix = Matrix<double>::uninitialized(rows, cols);
+  double *data = matrix.raw();
+  for (size_t i = 0; i < matrix.size(); ++i) {
+    data[i] = static_cast<double>(i % 97) * 0.25;
+  }
+  return matrix;
+}
+
+/**
+ * @brief Report a per-iteration amount as a rate, e.g. "FLOP=7.2G/s".
+ */
+void setRate(benchmark::State &state, const char *name, double perIteration) {
+  state.counters[name] = benchmark::Counter(
+      perIteration, benchmark::Counter::kIsIterationInvariantRate);
+}
+
+void BM_Construct(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  for (auto _ : state) {
+    Matrix<double> matrix(n, n);
+    benchmark::DoNotOptimize(matrix.raw());
+  }
+  setRate(state, "bytes", static_cast<double>(n * n * sizeof(double)));
+}
+BENCHMARK(BM_Construct)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_Copy(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Matrix<double> source = filled(n, n);
+  for (auto _ : state) {
+    Matrix<double> copy(n, n, source.raw());
+    benchmark::DoNotOptimize(copy.raw());
+  }
+  setRate(state, "bytes", 2.0 * static_cast<double>(n * n * sizeof(double)));
+}
+BENCHMARK(BM_Copy)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_Add(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Matrix<double> a = filled(n, n);
+  const Matrix<double> b = filled(n, n);
+  Matrix<double> c(n, n);
+  for (auto _ : state) {
+    c = a + b;
+    benchmark::ClobberMemory();
+  }
+  setRate(state, "FLOP", static_cast<double>(n * n));
+  setRate(state, "bytes", 3.0 * static_cast<double>(n * n * sizeof(double)));
+}
+BENCHMARK(BM_Add)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_FusedExpression(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Matrix<double> a = filled(n, n);
+  const Matrix<double> b = filled(n, n);
+  Matrix<double> c(n, n);
+  for (auto _ : state) {
+    c = a * 2.0 + b - a;
+    benchmark::ClobberMemory();
+  }
+  setRate(state, "FLOP", 3.0 * static_cast<double>(n * n));
+  setRate(state, "bytes", 3.0 * static_cast<double>(n * n * sizeof(double)));
+}
+BENCHMARK(BM_FusedExpression)->RangeMultiplier(4)->Range(16, 1024);
+
+void BM_ScalarBroadcast(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Matrix<double> a = filled(n, n);
+  const Matrix<double> scalar{{3.0}};
+  for (auto _ : state) {
+    Matrix<double> result = scalar * a;
+    benchmark::DoNotOptimize(result.raw());
+  }
+  setRate(state, "FLOP", static_cast<double>(n * n));
+  setRate(state, "bytes", 2.0 * static_cast<double>(n * n * sizeof(double)));
+}
+BENCHMARK(BM_ScalarBroadcast)->RangeMultiplier(4)->Range(16, 1024);
+
+/**
+ * @brief C(m x n) = A(m x k) * B(k x n).
+ */
+void BM_Gemm(benchmark::State &state) {
+  const auto m = static_cast<size_t>(state.range(0));
+  const auto k = static_cast<size_t>(state.range(1));
+  const auto n = static_cast<size_t>(state.range(2));
+  const Matrix<double> a = filled(m, k);
+  const Matrix<double> b = filled(k, n);
+  for (auto _ : state) {
+    Matrix<double> c = a * b;
+    benchmark::DoNotOptimize(c.raw());
+  }
+  setRate(state, "FLOP", 2.0 * static_cast<double>(m * n * k));
+  setRate(state, "bytes",
+          static_cast<double>((m * k + k * n + m * n) * sizeof(double)));
+}
+BENCHMARK(BM_Gemm)
+    ->ArgNames({"m", "k", "n"})
+    // Square
+    ->Args({32, 32, 32})
+    ->Args({128, 128, 128})
+    ->Args({512, 512, 512})
+    ->Args({1024, 1024, 1024})
+    // Tall-skinny and its transpose-shaped products
+    ->Args({4096, 16, 16})
+    ->Args({4096, 64, 4096})
+    ->Args({16, 4096, 16})
+    // Matrix-vector
+    ->Args({1024, 1024, 1})
+    ->Unit(benchmark::kMicrosecond);
+
+void BM_GemmStrassen(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const Matrix<double> a = filled(n, n);
+  const Matrix<double> b = filled(n, n);
+  for (auto _ : state) {
+    Matrix<double> c = a.multiply(b, gemm::Algorithm::STRASSEN);
+    benchmark::DoNotOptimize(c.raw());
+  }
+  // Nominal 2n^3 flops, so the rate is comparable with BM_Gemm.
+  setRate(state, "FLOP", 2.0 * static_cast<double>(n * n * n));
+}
+BENCHMARK(BM_GemmStrassen)
+    ->Arg(1024)
+    ->Arg(2048)
+    ->Arg(4096)
+    ->Unit(benchmark::kMillisecond);
+
+void BM_Transform4x4Dynamic(benchmark::State &state) {
+  const Matrix<double> transform = filled(4, 4);
+  Matrix<double> accumulated = filled(4, 4);
+  for (auto _ : state) {
+    accumulated = transform * accumulated;
+    benchmark::DoNotOptimize(accumulated.raw());
+  }
+  setRate(state, "FLOP", 2.0 * 4 * 4 * 4);
+}
+BENCHMARK(BM_Transform4x4Dynamic);
+
+void BM_Transform4x4Fixed(benchmark::State &state) {
+  const FixedMatrix<double, 4, 4> transform(filled(4, 4));
+  FixedMatrix<double, 4, 4> accumulated(filled(4, 4));
+  for (auto _ : state) {
+    accumulated = transform * accumulated;
+    benchmark::DoNotOptimize(accumulated.raw());
+  }
+  setRate(state, "FLOP", 2.0 * 4 * 4 * 4);
+}
+BENCHMARK(BM_Transform4x4Fixed);
+
+/**
+ * @brief n x n matrix with about 1% of its elements set.
+ */
+auto sparse(size_t n) -> SparseMatrix<double> {
+  Matrix<double> dense(n, n);
+  for (size_t i = 0; i < dense.size(); i += 97) {
+    dense.raw()[i] = static_cast<double>(i % 13) + 1.0;
+  }
+  return SparseMatrix<double>::fromDense(dense);
+}
+
+void BM_SparseTimesDense(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const SparseMatrix<double> a = sparse(n);
+  const Matrix<double> x = filled(n, 16);
+  for (auto _ : state) {
+    Matrix<double> result = a * x;
+    benchmark::DoNotOptimize(result.raw());
+  }
+  setRate(state, "FLOP", 2.0 * static_cast<double>(a.nonZeros() * 16));
+}
+BENCHMARK(BM_SparseTimesDense)->RangeMultiplier(4)->Range(256, 4096);
+
+void BM_SparseTimesSparse(benchmark::State &state) {
+  const auto n = static_cast<size_t>(state.range(0));
+  const SparseMatrix<double> a = sparse(n);
+  for (auto _ : state) {
+    SparseMatrix<double> result = a * a;
+    benchmark::DoNotOptimize(result.getValues().data());
+  }
+}
+BENCHMARK(BM_SparseTimesSparse)->RangeMultiplier(4)->Range(256, 4096);
+
+} // namespace
@@ -0,0 +1,90 @@
+#ifndef ALIGNED_ALLOCATOR_H
+#define ALIGNED_ALLOCATOR_H
+
+#include "Profiler.h"
+#include <cstddef>
+#include <new>
+#include <utility>
+
+/**
+ * @brief Alignment in bytes used for all matrix storage.
+ *
+ * 64 bytes covers a full cache line and the widest SIMD register (AVX-512).
+ */
+constexpr size_t MATRIX_ALIGNMENT = 64;
+
+/**
+ * @brief Standard allocator returning memory aligned to a fixed boundary.
+ *
+ * Elements constructed without arguments are default-initialized, so sizing
+ * a container of arithmetic types does not write the memory twice when it is
+ * about to be overwritten anyway.
+ *
+ * @tparam T Type of the elements.
+ * @tparam Alignment Alignment in bytes, must be a power of two.
+ */
+template <typename T, size_t Alignment = MATRIX_ALIGNMENT>
+class AlignedAllocator {
+public:
+  using value_type = T;
+
+  template <typename U> struct rebind {
+    using other = AlignedAllocator<U, Alignment>;
+  };
+
+  AlignedAllocator() noexcept = default;
+
+  template <typename U>
+  AlignedAllocator(const AlignedAllocator<U, Alignment> & /*other*/) noexcept {}
+
+  /**
+   * @brief Allocate storage for n elements.
+   *
+   * The allocation is counted by the Profiler.
+   *
+   * @param n Number of elements.
+   * @return T* Pointer aligned to Alignment bytes.
+   * @throws std::bad_alloc if the allocation fails.
+   */
+  auto allocate(size_t n) -> T * {
+    if (n == 0) {
+      return nullptr;
+    }
+    Profiler::countAllocation(n * sizeof(T));
+    return static_cast<T *>(
+        ::operator new(n * sizeof(T), std::align_val_t(Alignment)));
+  }
+
+  /**
+   * @brief Release storage obtained from allocate().
+   *
+   * @param p Pointer returned by allocate().
+   * @param n Number of elements (unused).
+   */
+  void deallocate(T *p, size_t /*n*/) noexcept {
+    ::operator delete(p, std::align_val_t(Alignment));
+  }
+
+  template <typename U> void construct(U *p) noexcept {
+    ::new (static_cast<void *>(p)) U;
+  }
+
+  template <typename U, typename... Args>
+  void construct(U *p, Args &&...args) {
+    ::new (static_cast<void *>(p)) U(std::forward<Args>(args)...);
+  }
+
+  template <typename U>
+  auto operator==(const AlignedAllocator<U, Alignment> & /*other*/) const
+      -> bool {
+    return true;
+  }
+
+  template <typename U>
+  auto operator!=(const AlignedAllocator<U, Alignment> & /*other*/) const
+      -> bool {
+    return false;
+  }
+};
+
+#endif // ALIGNED_ALLOCATOR_H
@@ -0,0 +1,107 @@
+#ifndef ARENA_H
+#define ARENA_H
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Bump allocator whose objects are all released together.
+ *
+ * Objects are carved out of large blocks and are never freed individually;
+ * destroying the arena runs the destructors of the objects that need one, in
+ * reverse order of creation, and then frees the blocks. Used for short-lived,
+ * allocation-heavy structures such as a statement's syntax tree.
+ */
+class Arena {
+public:
+  /**
+   * @brief Size in bytes of a regular block.
+   */
+  static constexpr size_t BLOCK_SIZE = 16 * 1024;
+
+  Arena() = default;
+  Arena(const Arena &) = delete;
+  auto operator=(const Arena &) -> Arena & = delete;
+
+  ~Arena() {
+    for (auto it = destructors.rbegin(); it != destructors.rend(); ++it) {
+      it->destroy(it->object);
+    }
+  }
+
+  /**
+   * @brief Construct an object in the arena.
+   *
+   * @param args Constructor arguments.
+   * @return T* The object, valid for the arena's lifetime.
+   */
+  template <typename T, typename... Args> auto create(Args &&...args) -> T * {
+    T *object = ::new (allocate(sizeof(T), alignof(T)))
+        T(std::forward<Args>(args)...);
+    if constexpr (!std::is_trivially_destructible_v<T>) {
+      destructors.push_back(
+          {object, [](void *p) { static_cast<T *>(p)->~T(); }});
+    }
+    return object;
+  }
+
+  /**
+   * @brief Copy a string into the arena.
+   *
+   * @param text Characters to copy.
+   * @return std::string_view View of the copy.
+   */
+  auto copy(std::string_view text) -> std::string_view {
+    if (text.empty()) {
+      return {};
+    }
+    auto *out = static_cast<char *>(allocate(text.size(), 1));
+    std::memcpy(out, text.data(), text.size());
+    return {out, text.size()};
+  }
+
+  /**
+   * @brief Allocate raw, uninitialized memory.
+   *
+   * @param size Number of bytes.
+   * @param alignment Required alignment, a power of two.
+   * @return void* Pointer to the memory.
+   */
+  auto allocate(size_t size, size_t alignment) -> void * {
+    auto address = reinterpret_cast<uintptr_t>(cursor);
+    size_t padding = (alignment - address % alignment) % alignment;
+    if (cursor == nullptr || padding + size > size_t(limit - cursor)) {
+      // Start a new block, enlarged for oversized requests.
+      const size_t bytes = std::max(BLOCK_SIZE, size + alignment);
+      blocks.emplace_back(new std::byte[bytes]);
+      cursor = blocks.back().get();
+      limit = cursor + bytes;
+      address = reinterpret_cast<uintptr_t>(cursor);
+      padding = (alignment - address % alignment) % alignment;
+    }
+    void *result = cursor + padding;
+    cursor += padding + size;
+    return result;
+  }
+
+private:
+  struct Destructor {
+    void *object;
+    void (*destroy)(void *);
+  };
+
+  std::vector<std::unique_ptr<std::byte[]>> blocks;
+  std::vector<Destructor> destructors;
+  std::byte *cursor = nullptr;
+  std::byte *limit = nullptr;
+};
+
+#endif // ARENA_H
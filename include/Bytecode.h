@@ -0,0 +1,130 @@
+#ifndef BYTECODE_H
+#define BYTECODE_H
+
+#include "Value.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Operations of the register-based virtual machine.
+ */
+enum class OpCode : uint8_t {
+  LOAD_CONST, // dst = constants[a]
+  LOAD_VAR,   // dst = variables[names[a]]
+  STORE_VAR,  // variables[names[a]] = registers[b]
+  FUSED,      // dst = kernels[a], stored into variables[names[b]] if b set
+  MUL,        // dst = a * b
+  CHAIN,      // dst = product of registers dst .. dst + a - 1
+  CALL        // dst = calls[a] applied to its arguments
+};
+
+/**
+ * @brief Functions callable from the language.
+ */
+enum class Builtin : uint8_t {
+  LOAD,    // load("file"): map a matrix file
+  SAVE,    // save(A, "file"): write A to a matrix file
+  READ_CSV, // readcsv("file"): import a delimited text file
+  SAVE_WS,  // savews("file"): snapshot all variables
+  LOAD_WS,  // loadws("file"): restore a snapshot
+  SPARSE,   // sparse(A): compressed sparse row copy of A
+  DENSE,    // dense(A): dense copy of A
+  SINGLE,   // single(A): convert A to float32
+  DOUBLE,   // double(A): convert A to float64
+  INT32     // int32(A): round A to int32
+};
+
+/**
+ * @brief One argument of a builtin call: a register or a string constant.
+ */
+struct CallArgument {
+  enum class Source : uint8_t { REGISTER, STRING };
+  Source source;
+  uint32_t index;
+};
+
+/**
+ * @brief A builtin call site with its arguments.
+ */
+struct BuiltinCall {
+  Builtin function;
+  std::vector<CallArgument> arguments;
+};
+
+/**
+ * @brief Operand index meaning "no operand".
+ */
+constexpr uint32_t NO_OPERAND = UINT32_MAX;
+
+/**
+ * @brief Where a fused kernel reads one of its inputs from.
+ *
+ * Variables and constants are read in place, without being copied into a
+ * register first.
+ */
+struct FusedOperand {
+  enum class Source : uint8_t { REGISTER, VARIABLE, CONSTANT };
+  Source source;
+  uint32_t index;
+};
+
+/**
+ * @brief One postfix step of a fused element-wise kernel.
+ */
+struct FusedStep {
+  enum class Kind : uint8_t {
+    INPUT, // push operands[input]
+    ADD,   // pop b, pop a, push a + b
+    SUB,   // pop b, pop a, push a - b
+    SCALE  // pop a, push a * factor
+  };
+  Kind kind;
+  uint32_t input;
+  double factor;
+};
+
+/**
+ * @brief A maximal element-wise subtree compiled to a single postfix kernel.
+ *
+ * The kernel is evaluated in one pass over its output, see evaluateFused().
+ */
+struct FusedKernel {
+  std::vector<FusedStep> steps;
+  std::vector<FusedOperand> operands;
+  uint32_t depth = 0;
+};
+
+/**
+ * @brief A single VM instruction with up to three operands.
+ *
+ * Operands index registers, constants or names depending on the opcode.
+ */
+struct Instruction {
+  OpCode op;
+  uint32_t dst;
+  uint32_t a;
+  uint32_t b;
+};
+
+/**
+ * @brief A compiled statement, independent of any variable values.
+ *
+ * Programs are immutable once built, so they can be cached and executed any
+ * number of times. Statements update 'ans' unless they call a builtin
+ * without a result.
+ */
+struct Program {
+  std::vector<Instruction> code;
+  std::vector<Value> constants; // Numbers and 1x1 literals are scalars
+  std::vector<FusedKernel> kernels;
+  std::vector<BuiltinCall> calls;
+  std::vector<std::string> names;
+  std::vector<std::string> strings;
+  uint32_t registerCount = 0;
+  uint32_t result = 0;
+  bool printResult = true;
+  bool setsAns = true;
+};
+
+#endif // BYTECODE_H
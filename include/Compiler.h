@@ -0,0 +1,62 @@
+#ifndef COMPILER_H
+#define COMPILER_H
+
+#include "Bytecode.h"
+#include "Parser.h"
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * @brief Lowers a parsed AST into a bytecode Program.
+ *
+ * Registers are allocated in stack order: an operator writes its result into
+ * the register of its left operand and frees the right one, so a statement
+ * needs as many registers as its expression tree is deep.
+ *
+ * Maximal element-wise subtrees (+, - and multiplication by a scalar literal)
+ * are planned as a single FusedKernel instead of one instruction per node.
+ * Their variable and literal leaves are read in place, and when such a
+ * subtree is the right-hand side of an assignment the kernel writes straight
+ * into the variable's buffer. The parser lowers X += Y, X -= Y and X *= s to
+ * X = X op Y, so these and hand-written X = X op Y updates run in place.
+ *
+ * A product of three or more factors, however it is parenthesized, becomes
+ * one CHAIN instruction with its factors in consecutive registers, so the
+ * interpreter can pick the multiplication order once their shapes are known.
+ */
+class Compiler {
+private:
+  Program program;
+  std::unordered_map<std::string_view, uint32_t> nameSlots;
+  uint32_t top = 0;
+
+  auto emit(const Expression *expr) -> uint32_t;
+  auto emitBinary(const BinaryExpr *expr) -> uint32_t;
+  static void collectFactors(const Expression *expr,
+                             std::vector<const Expression *> &factors);
+  auto emitCall(const CallExpr *expr) -> uint32_t;
+  auto emitFused(const Expression *expr, uint32_t target) -> uint32_t;
+  void planFused(const Expression *expr, FusedKernel &kernel, uint32_t &height);
+  static auto isElementwise(const Expression *expr) -> bool;
+  static auto scalarLiteral(const Expression *expr, double &value) -> bool;
+  auto constant(const Expression *expr) -> uint32_t;
+  auto allocate() -> uint32_t;
+  auto nameSlot(std::string_view name) -> uint32_t;
+
+public:
+  /**
+   * @brief Compile one expression statement.
+   *
+   * @param expression Root of the AST.
+   * @param printResult Whether the statement's value should be printed.
+   * @return std::shared_ptr<const Program> The compiled program.
+   */
+  static auto compile(const std::shared_ptr<Expression> &expression,
+                      bool printResult = true)
+      -> std::shared_ptr<const Program>;
+};
+
+#endif // COMPILER_H
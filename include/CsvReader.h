@@ -0,0 +1,26 @@
+#ifndef CSV_READER_H
+#define CSV_READER_H
+
+#include "Matrix.h"
+#include <string>
+
+/**
+ * @brief Read a matrix from a CSV or whitespace-delimited text file.
+ *
+ * Each non-blank line is a row. Values are separated by a comma, optionally
+ * surrounded by blanks, or by blanks alone, and are scanned with
+ * Lexer::scanNumber (with an optional sign). A first line that is not
+ * entirely numeric is taken as a header and skipped.
+ *
+ * The file is mapped, split into line-aligned chunks, and the chunks are
+ * parsed in parallel on the ThreadPool, each writing its rows straight into
+ * the result.
+ *
+ * @param path Path of the file.
+ * @return Matrix<double> The matrix.
+ * @throws std::runtime_error if the file cannot be read, a value is not a
+ * number, or the rows differ in length.
+ */
+auto readCsv(const std::string &path) -> Matrix<double>;
+
+#endif // CSV_READER_H
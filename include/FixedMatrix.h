@@ -0,0 +1,242 @@
+#ifndef FIXED_MATRIX_H
+#define FIXED_MATRIX_H
+
+#include "Matrix.h"
+#include <cstddef>
+#include <initializer_list>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <utility>
+
+/**
+ * @brief A matrix whose shape is fixed at compile time.
+ *
+ * The elements live inside the object, row-major, so a FixedMatrix never
+ * allocates and is as cheap to copy as the equivalent array. Every
+ * operation is constexpr and expands over the elements at compile time,
+ * leaving no loops for small shapes such as 4x4 transforms. The inner
+ * dimension of a product is checked by the type system.
+ *
+ * Use it for small matrices in C++ code; it converts to and from the
+ * dynamically sized Matrix at API boundaries.
+ *
+ * @tparam T Type of the elements.
+ * @tparam R Number of rows.
+ * @tparam C Number of columns.
+ */
+template <typename T, size_t R, size_t C> class FixedMatrix {
+  static_assert(R > 0 && C > 0, "A fixed matrix cannot be empty");
+
+public:
+  using Scalar = T;
+
+private:
+  T elements[R * C]{};
+
+  /**
+   * @brief Build a matrix whose element (i, j) is f(i, j).
+   */
+  template <typename F, size_t... I>
+  static constexpr auto generate(F f, std::index_sequence<I...> /*unused*/)
+      -> FixedMatrix<T, R, C> {
+    FixedMatrix<T, R, C> result;
+    ((result.elements[I] = f(I / C, I % C)), ...);
+    return result;
+  }
+
+public:
+  /**
+   * @brief Default constructor: all elements are zero.
+   */
+  constexpr FixedMatrix() = default;
+
+  /**
+   * @brief Constructor with initializer list.
+   *
+   * @param list Rows of the matrix.
+   * @throws std::invalid_argument if the list does not have R rows of C
+   * elements.
+   */
+  constexpr FixedMatrix(std::initializer_list<std::initializer_list<T>> list) {
+    if (list.size() != R) {
+      throw std::invalid_argument("Fixed matrix must have matching rows");
+    }
+    size_t i = 0;
+    for (const auto &row : list) {
+      if (row.size() != C) {
+        throw std::invalid_argument("All rows must have the same size");
+      }
+      for (const T &value : row) {
+        elements[i++] = value;
+      }
+    }
+  }
+
+  /**
+   * @brief Copy a dynamically sized matrix of the same shape.
+   *
+   * @param matrix Matrix to copy.
+   * @throws std::invalid_argument if the shapes differ.
+   */
+  explicit FixedMatrix(const Matrix<T> &matrix) {
+    if (matrix.getRows() != R || matrix.getCols() != C) {
+      throw std::invalid_argument(
+          "Matrix dimensions must match for conversion");
+    }
+    for (size_t i = 0; i < R; ++i) {
+      const T *row = matrix.rowPtr(i);
+      for (size_t j = 0; j < C; ++j) {
+        elements[i * C + j] = row[j];
+      }
+    }
+  }
+
+  /**
+   * @brief Build a matrix element by element.
+   *
+   * @param f Callable returning element (i, j) for f(i, j).
+   * @return FixedMatrix<T, R, C> The matrix.
+   */
+  template <typename F>
+  static constexpr auto generate(F f) -> FixedMatrix<T, R, C> {
+    return generate(f, std::make_index_sequence<R * C>());
+  }
+
+  /**
+   * @brief The identity matrix.
+   *
+   * @return FixedMatrix<T, R, C> Ones on the diagonal, zeros elsewhere.
+   */
+  static constexpr auto identity() -> FixedMatrix<T, R, C> {
+    static_assert(R == C, "Identity matrix must be square");
+    return generate([](size_t i, size_t j) { return T(i == j ? 1 : 0); });
+  }
+
+  /**
+   * @brief Convert to a dynamically sized matrix.
+   *
+   * @return Matrix<T> A matrix with a copy of the elements.
+   */
+  operator Matrix<T>() const { return Matrix<T>(R, C, elements); }
+
+  constexpr auto operator()(size_t row, size_t col) -> T & {
+    return elements[row * C + col];
+  }
+
+  constexpr auto operator()(size_t row, size_t col) const -> const T & {
+    return elements[row * C + col];
+  }
+
+  [[nodiscard]] static constexpr auto getRows() -> size_t { return R; }
+  [[nodiscard]] static constexpr auto getCols() -> size_t { return C; }
+  [[nodiscard]] static constexpr auto size() -> size_t { return R * C; }
+
+  constexpr auto raw() -> T * { return elements; }
+  [[nodiscard]] constexpr auto raw() const -> const T * { return elements; }
+
+  [[nodiscard]] constexpr auto transpose() const -> FixedMatrix<T, C, R> {
+    return FixedMatrix<T, C, R>::generate(
+        [this](size_t i, size_t j) { return (*this)(j, i); });
+  }
+
+  constexpr auto operator+(const FixedMatrix<T, R, C> &other) const
+      -> FixedMatrix<T, R, C> {
+    return generate([&](size_t i, size_t j) {
+      return (*this)(i, j) + other(i, j);
+    });
+  }
+
+  constexpr auto operator-(const FixedMatrix<T, R, C> &other) const
+      -> FixedMatrix<T, R, C> {
+    return generate([&](size_t i, size_t j) {
+      return (*this)(i, j) - other(i, j);
+    });
+  }
+
+  constexpr auto operator-() const -> FixedMatrix<T, R, C> {
+    return generate([this](size_t i, size_t j) { return -(*this)(i, j); });
+  }
+
+  constexpr auto operator*(T scalar) const -> FixedMatrix<T, R, C> {
+    return generate(
+        [&](size_t i, size_t j) { return (*this)(i, j) * scalar; });
+  }
+
+  friend constexpr auto operator*(T scalar, const FixedMatrix<T, R, C> &m)
+      -> FixedMatrix<T, R, C> {
+    return m * scalar;
+  }
+
+  constexpr auto operator+=(const FixedMatrix<T, R, C> &other)
+      -> FixedMatrix<T, R, C> & {
+    return *this = *this + other;
+  }
+
+  constexpr auto operator-=(const FixedMatrix<T, R, C> &other)
+      -> FixedMatrix<T, R, C> & {
+    return *this = *this - other;
+  }
+
+  constexpr auto operator*=(T scalar) -> FixedMatrix<T, R, C> & {
+    return *this = *this * scalar;
+  }
+
+  constexpr auto operator==(const FixedMatrix<T, R, C> &other) const
+      -> bool {
+    for (size_t i = 0; i < R * C; ++i) {
+      if (elements[i] != other.elements[i]) {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  constexpr auto operator!=(const FixedMatrix<T, R, C> &other) const
+      -> bool {
+    return !(*this == other);
+  }
+
+  friend auto operator<<(std::ostream &os, const FixedMatrix<T, R, C> &m)
+      -> std::ostream & {
+    for (size_t i = 0; i < R; ++i) {
+      for (size_t j = 0; j < C; ++j) {
+        os << std::setw(8) << m(i, j);
+      }
+      os << '\n';
+    }
+    return os;
+  }
+};
+
+namespace fixed {
+
+/**
+ * @brief Row i of a times column j of b, as one unrolled sum.
+ */
+template <typename T, size_t R, size_t K, size_t C, size_t... I>
+constexpr auto dot(const FixedMatrix<T, R, K> &a,
+                   const FixedMatrix<T, K, C> &b, size_t i, size_t j,
+                   std::index_sequence<I...> /*unused*/) -> T {
+  return (T() + ... + (a(i, I) * b(I, j)));
+}
+
+} // namespace fixed
+
+/**
+ * @brief Matrix product; mismatched inner dimensions do not compile.
+ *
+ * @param a Left operand, R x K.
+ * @param b Right operand, K x C.
+ * @return FixedMatrix<T, R, C> The product.
+ */
+template <typename T, size_t R, size_t K, size_t C>
+constexpr auto operator*(const FixedMatrix<T, R, K> &a,
+                         const FixedMatrix<T, K, C> &b)
+    -> FixedMatrix<T, R, C> {
+  return FixedMatrix<T, R, C>::generate([&](size_t i, size_t j) {
+    return fixed::dot(a, b, i, j, std::make_index_sequence<K>());
+  });
+}
+
+#endif // FIXED_MATRIX_H
@@ -0,0 +1,77 @@
+#ifndef FUSION_H
+#define FUSION_H
+
+#include "Bytecode.h"
+#include "Value.h"
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Shape of a fused kernel's result.
+ *
+ * Replays the stack on shapes alone, so the error names the operation. A
+ * 1x1 operand of an addition or subtraction is broadcast against the other.
+ *
+ * @param kernel Kernel to check.
+ * @param inputs One value per kernel operand.
+ * @return std::pair<size_t, size_t> Rows and columns of the result.
+ * @throws std::invalid_argument if the inputs' shapes differ and neither is
+ * 1x1.
+ */
+auto fusedShape(const FusedKernel &kernel,
+                const std::vector<const Value *> &inputs)
+    -> std::pair<size_t, size_t>;
+
+/**
+ * @brief Evaluate a fused element-wise kernel in a single pass.
+ *
+ * Instantiated for double, float and int32_t. Every operand must be 1x1 or
+ * a dense Matrix<T>; 1x1 operands and scale factors are converted to T.
+ *
+ * The output is produced CHUNK elements at a time: inputs are read in place,
+ * intermediate values live in per-stack-slot scratch chunks, and only the
+ * last step writes to out. Every input is read once and out is written once.
+ * 1x1 inputs are broadcast: they stay scalars on the stack and combine with
+ * chunks through the SIMD broadcast kernels.
+ *
+ * If out already has the result shape its buffer is reused, which is safe
+ * even when out is one of the inputs; otherwise out is replaced by a new
+ * matrix. Shapes are checked before anything is written.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param inputs One value per kernel operand.
+ * @param out Destination.
+ * @throws std::invalid_argument if the inputs' shapes differ and neither is
+ * 1x1.
+ */
+template <typename T>
+void evaluateFused(const FusedKernel &kernel,
+                   const std::vector<const Value *> &inputs, Matrix<T> &out);
+
+/**
+ * @brief Evaluate a fused kernel whose inputs are all 1x1, without
+ * allocating.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param inputs One 1x1 value per kernel operand.
+ * @return double The result.
+ */
+auto evaluateFusedScalar(const FusedKernel &kernel,
+                         const std::vector<const Value *> &inputs)
+    -> double;
+
+/**
+ * @brief Evaluate a fused kernel with sparse inputs, one step at a time.
+ *
+ * Each step goes through add() and scale(), so sums of sparse operands stay
+ * sparse and a sparse operand meeting a dense one is densified.
+ *
+ * @param kernel Kernel to evaluate.
+ * @param inputs One value per kernel operand.
+ * @return Value The result.
+ * @throws std::invalid_argument if the inputs' shapes differ.
+ */
+auto evaluateFused(const FusedKernel &kernel,
+                   const std::vector<const Value *> &inputs) -> Value;
+
+#endif // FUSION_H
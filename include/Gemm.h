@@ -0,0 +1,529 @@
+#ifndef GEMM_H
+#define GEMM_H
+
+#include "AlignedAllocator.h"
+#include "Simd.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <vector>
+
+/**
+ * @brief Packed, cache-blocked general matrix multiply (GotoBLAS/BLIS style).
+ *
+ * C = A * B is computed with three levels of blocking: B is packed into
+ * KC x NC panels that stay in L3, A into MC x KC blocks that stay in L2, and
+ * an MR x NR register micro-kernel streams one KC-long sliver of each from L1.
+ * All matrices are row-major with an explicit leading dimension (stride).
+ * The micro-kernel, and the blocking sizes that go with it, are picked by
+ * simd::level(): FMA kernels for AVX2 and AVX-512, a portable one otherwise.
+ *
+ * Large products are split into output tiles (MC rows by a multiple of NR
+ * columns) that are spread over the shared ThreadPool; each worker packs its
+ * own A block while the B panel is packed once per KC step and shared.
+ */
+namespace gemm {
+
+/**
+ * @brief Blocking parameters of the portable micro-kernel for a given
+ * element type.
+ *
+ * MR x NR accumulators fit in sixteen 128-bit registers so the micro-kernel
+ * vectorizes on the SSE2 baseline; KC * NR elements of packed B fit in L1 and
+ * MC * KC elements of packed A fit in L2.
+ */
+template <typename T> struct BlockSizes {
+  static constexpr size_t MR = 4;
+  static constexpr size_t NR = 4;
+  static constexpr size_t KC = 256;
+  static constexpr size_t MC = 64;
+  static constexpr size_t NC = 2048;
+};
+
+template <> struct BlockSizes<double> {
+  static constexpr size_t MR = 4;
+  static constexpr size_t NR = 8;
+  static constexpr size_t KC = 256;
+  static constexpr size_t MC = 96;
+  static constexpr size_t NC = 4096;
+};
+
+template <> struct BlockSizes<float> {
+  static constexpr size_t MR = 4;
+  static constexpr size_t NR = 16;
+  static constexpr size_t KC = 256;
+  static constexpr size_t MC = 96;
+  static constexpr size_t NC = 4096;
+};
+
+/**
+ * @brief How large square products are computed, see Matrix::multiply().
+ */
+enum class Algorithm : uint8_t {
+  STANDARD, // Blocked O(n^3) kernel, accurate componentwise
+  STRASSEN  // Strassen-Winograd above STRASSEN_CROSSOVER, see strassen()
+};
+
+/**
+ * @brief Products with fewer multiply-adds than this use the simple kernel.
+ */
+constexpr size_t BLOCKED_THRESHOLD = 64 * 64 * 64;
+
+/**
+ * @brief Products with fewer multiply-adds than this run on a single thread.
+ */
+constexpr size_t PARALLEL_THRESHOLD = 192 * 192 * 192;
+
+template <typename T>
+using Buffer = std::vector<T, AlignedAllocator<T>>;
+
+/**
+ * @brief Portable MR x NR register micro-kernel over one packed A and B
+ * sliver.
+ *
+ * @param kc Depth of the slivers.
+ * @param a Packed A sliver (kc x MR).
+ * @param b Packed B sliver (kc x NR).
+ * @param c Top-left element of the output tile.
+ * @param ldc Leading dimension of C.
+ * @param mr Valid rows of the tile (<= MR).
+ * @param nr Valid columns of the tile (<= NR).
+ * @param accumulate Add to C instead of overwriting it.
+ */
+template <typename T>
+void microKernel(size_t kc, const T *__restrict a, const T *__restrict b,
+                 T *__restrict c, size_t ldc, size_t mr, size_t nr,
+                 bool accumulate) {
+  constexpr size_t MR = BlockSizes<T>::MR;
+  constexpr size_t NR = BlockSizes<T>::NR;
+  alignas(MATRIX_ALIGNMENT) T acc[MR][NR] = {};
+
+  for (size_t p = 0; p < kc; ++p) {
+    for (size_t i = 0; i < MR; ++i) {
+      const T ai = a[i];
+      for (size_t j = 0; j < NR; ++j) {
+        acc[i][j] += ai * b[j];
+      }
+    }
+    a += MR;
+    b += NR;
+  }
+
+  if (mr == MR && nr == NR) {
+    for (size_t i = 0; i < MR; ++i) {
+      T *row = c + i * ldc;
+      if (accumulate) {
+        for (size_t j = 0; j < NR; ++j) {
+          row[j] += acc[i][j];
+        }
+      } else {
+        for (size_t j = 0; j < NR; ++j) {
+          row[j] = acc[i][j];
+        }
+      }
+    }
+    return;
+  }
+  for (size_t i = 0; i < mr; ++i) {
+    T *row = c + i * ldc;
+    for (size_t j = 0; j < nr; ++j) {
+      row[j] = accumulate ? row[j] + acc[i][j] : acc[i][j];
+    }
+  }
+}
+
+#ifdef NL_SIMD_X86
+namespace detail {
+
+// Register traits of the vector micro-kernels, as in simd::detail but with
+// fused multiply-adds.
+#define NL_GEMM_REGISTER(NAME, TARGET, TYPE, VEC, WIDTH, SFX, PFX)             \
+  struct NAME {                                                                \
+    using T = TYPE;                                                            \
+    using V = VEC;                                                             \
+    static constexpr size_t width = WIDTH;                                     \
+    TARGET static auto zero() -> V { return PFX##_setzero_##SFX(); }           \
+    TARGET static auto load(const T *p) -> V { return PFX##_loadu_##SFX(p); }  \
+    TARGET static void store(T *p, V v) { PFX##_storeu_##SFX(p, v); }          \
+    TARGET static auto set1(T s) -> V { return PFX##_set1_##SFX(s); }          \
+    TARGET static auto add(V a, V b) -> V { return PFX##_add_##SFX(a, b); }    \
+    TARGET static auto fmadd(V a, V b, V c) -> V {                             \
+      return PFX##_fmadd_##SFX(a, b, c);                                       \
+    }                                                                          \
+  };
+
+// The micro-kernel of microKernel() with MR x NR / width accumulator
+// registers. The loops have constant bounds, so they unroll and the
+// accumulators never leave the registers.
+#define NL_GEMM_KERNEL(TARGET)                                                 \
+  template <typename R, size_t MR, size_t NR>                                  \
+  TARGET void microKernel(size_t kc, const typename R::T *__restrict a,        \
+                          const typename R::T *__restrict b,                   \
+                          typename R::T *__restrict c, size_t ldc, size_t mr,  \
+                          size_t nr, bool accumulate) {                        \
+    using T = typename R::T;                                                   \
+    constexpr size_t W = R::width;                                             \
+    constexpr size_t NV = NR / W;                                              \
+    typename R::V acc[MR][NV];                                                 \
+    for (size_t i = 0; i < MR; ++i) {                                          \
+      for (size_t v = 0; v < NV; ++v) {                                        \
+        acc[i][v] = R::zero();                                                 \
+      }                                                                        \
+    }                                                                          \
+    for (size_t p = 0; p < kc; ++p) {                                          \
+      typename R::V bp[NV];                                                    \
+      for (size_t v = 0; v < NV; ++v) {                                        \
+        bp[v] = R::load(b + v * W);                                            \
+      }                                                                        \
+      for (size_t i = 0; i < MR; ++i) {                                        \
+        const auto ai = R::set1(a[i]);                                         \
+        for (size_t v = 0; v < NV; ++v) {                                      \
+          acc[i][v] = R::fmadd(ai, bp[v], acc[i][v]);                          \
+        }                                                                      \
+      }                                                                        \
+      a += MR;                                                                 \
+      b += NR;                                                                 \
+    }                                                                          \
+                                                                               \
+    if (mr == MR && nr == NR) {                                                \
+      for (size_t i = 0; i < MR; ++i) {                                        \
+        for (size_t v = 0; v < NV; ++v) {                                      \
+          T *out = c + i * ldc + v * W;                                        \
+          R::store(out,                                                        \
+                   accumulate ? R::add(R::load(out), acc[i][v]) : acc[i][v]);  \
+        }                                                                      \
+      }                                                                        \
+      return;                                                                  \
+    }                                                                          \
+    alignas(MATRIX_ALIGNMENT) T tile[MR][NR];                                  \
+    for (size_t i = 0; i < MR; ++i) {                                          \
+      for (size_t v = 0; v < NV; ++v) {                                        \
+        R::store(tile[i] + v * W, acc[i][v]);                                  \
+      }                                                                        \
+    }                                                                          \
+    for (size_t i = 0; i < mr; ++i) {                                          \
+      T *row = c + i * ldc;                                                    \
+      for (size_t j = 0; j < nr; ++j) {                                        \
+        row[j] = accumulate ? row[j] + tile[i][j] : tile[i][j];                \
+      }                                                                        \
+    }                                                                          \
+  }
+
+namespace avx2 {
+#define NL_TARGET_AVX2 __attribute__((target("avx2,fma")))
+NL_GEMM_REGISTER(F64, NL_TARGET_AVX2, double, __m256d, 4, pd, _mm256)
+NL_GEMM_REGISTER(F32, NL_TARGET_AVX2, float, __m256, 8, ps, _mm256)
+NL_GEMM_KERNEL(NL_TARGET_AVX2)
+#undef NL_TARGET_AVX2
+} // namespace avx2
+
+namespace avx512 {
+#define NL_TARGET_AVX512 __attribute__((target("avx512f")))
+NL_GEMM_REGISTER(F64, NL_TARGET_AVX512, double, __m512d, 8, pd, _mm512)
+NL_GEMM_REGISTER(F32, NL_TARGET_AVX512, float, __m512, 16, ps, _mm512)
+NL_GEMM_KERNEL(NL_TARGET_AVX512)
+#undef NL_TARGET_AVX512
+} // namespace avx512
+
+#undef NL_GEMM_KERNEL
+#undef NL_GEMM_REGISTER
+
+template <typename T> struct Registers;
+
+template <> struct Registers<double> {
+  using Avx2 = avx2::F64;
+  using Avx512 = avx512::F64;
+};
+
+template <> struct Registers<float> {
+  using Avx2 = avx2::F32;
+  using Avx512 = avx512::F32;
+};
+
+} // namespace detail
+#endif // NL_SIMD_X86
+
+/**
+ * @brief A micro-kernel and the blocking parameters it is tuned for.
+ *
+ * The portable kernel is microKernel() with BlockSizes<T>. The AVX2 kernel
+ * keeps 6 x 2 accumulators in twelve of the sixteen ymm registers, the
+ * AVX-512 kernel 12 x 2 in 24 of the 32 zmm registers; the remaining
+ * registers hold the B row and the broadcast A element. MC is a multiple of
+ * MR, and KC * NR elements of packed B still fit in L1.
+ *
+ * @tparam T Element type.
+ * @tparam L Instruction set level; only float and double have vector kernels.
+ */
+template <typename T, simd::Level L> struct Kernel : BlockSizes<T> {
+  static void run(size_t kc, const T *a, const T *b, T *c, size_t ldc,
+                  size_t mr, size_t nr, bool accumulate) {
+    microKernel(kc, a, b, c, ldc, mr, nr, accumulate);
+  }
+};
+
+#ifdef NL_SIMD_X86
+template <typename T> struct Kernel<T, simd::Level::AVX2> {
+  using R = typename detail::Registers<T>::Avx2;
+  static constexpr size_t MR = 6;
+  static constexpr size_t NR = 2 * R::width;
+  static constexpr size_t KC = 256;
+  static constexpr size_t MC = 96;
+  static constexpr size_t NC = 4096;
+
+  static void run(size_t kc, const T *a, const T *b, T *c, size_t ldc,
+                  size_t mr, size_t nr, bool accumulate) {
+    detail::avx2::microKernel<R, MR, NR>(kc, a, b, c, ldc, mr, nr,
+                                         accumulate);
+  }
+};
+
+template <typename T> struct Kernel<T, simd::Level::AVX512> {
+  using R = typename detail::Registers<T>::Avx512;
+  static constexpr size_t MR = 12;
+  static constexpr size_t NR = 2 * R::width;
+  static constexpr size_t KC = 256;
+  static constexpr size_t MC = 96;
+  static constexpr size_t NC = 4096;
+
+  static void run(size_t kc, const T *a, const T *b, T *c, size_t ldc,
+                  size_t mr, size_t nr, bool accumulate) {
+    detail::avx512::microKernel<R, MR, NR>(kc, a, b, c, ldc, mr, nr,
+                                           accumulate);
+  }
+};
+#endif // NL_SIMD_X86
+
+/**
+ * @brief Pack an mc x kc block of A into MR-row panels, zero-padding the last.
+ */
+template <typename K, typename T>
+void packA(const T *a, size_t lda, size_t mc, size_t kc, T *out) {
+  constexpr size_t MR = K::MR;
+  for (size_t ir = 0; ir < mc; ir += MR) {
+    const size_t mr = std::min(MR, mc - ir);
+    for (size_t p = 0; p < kc; ++p) {
+      for (size_t i = 0; i < mr; ++i) {
+        out[i] = a[(ir + i) * lda + p];
+      }
+      for (size_t i = mr; i < MR; ++i) {
+        out[i] = T(0);
+      }
+      out += MR;
+    }
+  }
+}
+
+/**
+ * @brief Pack a kc x nc block of B into NR-column panels, zero-padding the
+ * last.
+ */
+template <typename K, typename T>
+void packB(const T *b, size_t ldb, size_t kc, size_t nc, T *out) {
+  constexpr size_t NR = K::NR;
+  for (size_t jr = 0; jr < nc; jr += NR) {
+    const size_t nr = std::min(NR, nc - jr);
+    for (size_t p = 0; p < kc; ++p) {
+      const T *row = b + p * ldb + jr;
+      for (size_t j = 0; j < nr; ++j) {
+        out[j] = row[j];
+      }
+      for (size_t j = nr; j < NR; ++j) {
+        out[j] = T(0);
+      }
+      out += NR;
+    }
+  }
+}
+
+/**
+ * @brief Multiply a packed MC x KC block of A by a packed KC x NC panel of B.
+ */
+template <typename K, typename T>
+void macroKernel(size_t mc, size_t nc, size_t kc, const T *packedA,
+                 const T *packedB, T *c, size_t ldc, bool accumulate) {
+  constexpr size_t MR = K::MR;
+  constexpr size_t NR = K::NR;
+  for (size_t jr = 0; jr < nc; jr += NR) {
+    const size_t nr = std::min(NR, nc - jr);
+    const T *b = packedB + jr * kc;
+    for (size_t ir = 0; ir < mc; ir += MR) {
+      const size_t mr = std::min(MR, mc - ir);
+      K::run(kc, packedA + ir * kc, b, c + ir * ldc + jr, ldc, mr, nr,
+             accumulate);
+    }
+  }
+}
+
+/**
+ * @brief blocked() with the micro-kernel K.
+ */
+template <typename K, typename T>
+void blockedWith(size_t m, size_t n, size_t k, const T *a, size_t lda,
+                 const T *b, size_t ldb, T *c, size_t ldc) {
+  const size_t ncMax = std::min(K::NC, (n + K::NR - 1) / K::NR * K::NR);
+  const size_t mcMax = std::min(K::MC, (m + K::MR - 1) / K::MR * K::MR);
+  const size_t kcMax = std::min(K::KC, k);
+  Buffer<T> packedB(kcMax * ncMax);
+
+  ThreadPool &pool = ThreadPool::instance();
+  const size_t threads = pool.threadCount();
+  if (threads <= 1 || m * n * k < PARALLEL_THRESHOLD) {
+    Buffer<T> packedA(mcMax * kcMax);
+    for (size_t jc = 0; jc < n; jc += K::NC) {
+      const size_t nc = std::min(K::NC, n - jc);
+      for (size_t pc = 0; pc < k; pc += K::KC) {
+        const size_t kc = std::min(K::KC, k - pc);
+        packB<K>(b + pc * ldb + jc, ldb, kc, nc, packedB.data());
+        for (size_t ic = 0; ic < m; ic += K::MC) {
+          const size_t mc = std::min(K::MC, m - ic);
+          packA<K>(a + ic * lda + pc, lda, mc, kc, packedA.data());
+          macroKernel<K>(mc, nc, kc, packedA.data(), packedB.data(),
+                         c + ic * ldc + jc, ldc, pc > 0);
+        }
+      }
+    }
+    return;
+  }
+
+  // Minimum tile width in NR panels, so packing A stays cheap next to the
+  // tile's flops.
+  constexpr size_t MIN_TILE_PANELS = 16;
+  const size_t rowBlocks = (m + K::MC - 1) / K::MC;
+
+  for (size_t jc = 0; jc < n; jc += K::NC) {
+    const size_t nc = std::min(K::NC, n - jc);
+    const size_t panels = (nc + K::NR - 1) / K::NR;
+    const size_t wanted = (2 * threads + rowBlocks - 1) / rowBlocks;
+    const size_t colBlocks = std::max<size_t>(
+        1, std::min(wanted, panels / MIN_TILE_PANELS));
+    const size_t panelsPerBlock = (panels + colBlocks - 1) / colBlocks;
+    const size_t packGroups = std::min(panels, threads);
+    const size_t panelsPerGroup = (panels + packGroups - 1) / packGroups;
+
+    for (size_t pc = 0; pc < k; pc += K::KC) {
+      const size_t kc = std::min(K::KC, k - pc);
+      const T *bBlock = b + pc * ldb + jc;
+
+      pool.parallelFor(packGroups, [&](size_t g) {
+        const size_t jr = g * panelsPerGroup * K::NR;
+        if (jr < nc) {
+          const size_t width = std::min(panelsPerGroup * K::NR, nc - jr);
+          packB<K>(bBlock + jr, ldb, kc, width, packedB.data() + jr * kc);
+        }
+      });
+
+      pool.parallelFor(rowBlocks * colBlocks, [&](size_t tile) {
+        const size_t ic = (tile / colBlocks) * K::MC;
+        const size_t jr = (tile % colBlocks) * panelsPerBlock * K::NR;
+        if (jr >= nc) {
+          return;
+        }
+        const size_t mc = std::min(K::MC, m - ic);
+        const size_t width = std::min(panelsPerBlock * K::NR, nc - jr);
+        thread_local Buffer<T> packedA;
+        packedA.resize(mcMax * kcMax);
+        packA<K>(a + ic * lda + pc, lda, mc, kc, packedA.data());
+        macroKernel<K>(mc, width, kc, packedA.data(),
+                       packedB.data() + jr * kc, c + ic * ldc + jc + jr, ldc,
+                       pc > 0);
+      });
+    }
+  }
+}
+
+/**
+ * @brief Blocked C = A * B, overwriting C.
+ *
+ * @param m Rows of A and C.
+ * @param n Columns of B and C.
+ * @param k Columns of A and rows of B.
+ * @param a Pointer to A.
+ * @param lda Leading dimension of A.
+ * @param b Pointer to B.
+ * @param ldb Leading dimension of B.
+ * @param c Pointer to C.
+ * @param ldc Leading dimension of C.
+ */
+template <typename T>
+void blocked(size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b,
+             size_t ldb, T *c, size_t ldc) {
+  if (m == 0 || n == 0) {
+    return;
+  }
+  if (k == 0) {
+    for (size_t i = 0; i < m; ++i) {
+      std::fill(c + i * ldc, c + i * ldc + n, T(0));
+    }
+    return;
+  }
+
+#ifdef NL_SIMD_X86
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    switch (simd::level()) {
+    case simd::Level::AVX512:
+      blockedWith<Kernel<T, simd::Level::AVX512>>(m, n, k, a, lda, b, ldb, c,
+                                                  ldc);
+      return;
+    case simd::Level::AVX2:
+      blockedWith<Kernel<T, simd::Level::AVX2>>(m, n, k, a, lda, b, ldb, c,
+                                                ldc);
+      return;
+    case simd::Level::SSE2:
+    case simd::Level::SCALAR:
+      break;
+    }
+  }
+#endif
+  blockedWith<Kernel<T, simd::Level::SCALAR>>(m, n, k, a, lda, b, ldb, c,
+                                              ldc);
+}
+
+/**
+ * @brief Straightforward i-k-j product for small or non-floating operands.
+ *
+ * C must be zero-initialized.
+ */
+template <typename T>
+void simple(size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b,
+            size_t ldb, T *c, size_t ldc) {
+  for (size_t i = 0; i < m; ++i) {
+    T *out = c + i * ldc;
+    const T *ai = a + i * lda;
+    for (size_t p = 0; p < k; ++p) {
+      const T aip = ai[p];
+      const T *bp = b + p * ldb;
+      for (size_t j = 0; j < n; ++j) {
+        out[j] += aip * bp[j];
+      }
+    }
+  }
+}
+
+/**
+ * @brief C = A * B, choosing the blocked kernel for large floating products.
+ *
+ * C must be zero-initialized. Signed integer products wrap around on
+ * overflow.
+ */
+template <typename T>
+void multiply(size_t m, size_t n, size_t k, const T *a, size_t lda, const T *b,
+              size_t ldb, T *c, size_t ldc) {
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    simple(m, n, k, reinterpret_cast<const U *>(a), lda,
+           reinterpret_cast<const U *>(b), ldb, reinterpret_cast<U *>(c), ldc);
+    return;
+  }
+  if (std::is_floating_point_v<T> && m * n * k >= BLOCKED_THRESHOLD) {
+    blocked(m, n, k, a, lda, b, ldb, c, ldc);
+  } else {
+    simple(m, n, k, a, lda, b, ldb, c, ldc);
+  }
+}
+
+} // namespace gemm
+
+#endif // GEMM_H
@@ -1,30 +1,136 @@
 #ifndef INTERPRETER_H
 #define INTERPRETER_H
 
+#include "Bytecode.h"
 #include "Parser.h"
+#include "Value.h"
+#include "Workspace.h"
+#include <chrono>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 class Interpreter {
 private:
-  std::unordered_map<std::string, Matrix<double>> variables;
-  Matrix<double> lastResult;
+  /**
+   * @brief Compiled programs kept per source line before the cache is reset.
+   */
+  static constexpr size_t PROGRAM_CACHE_LIMIT = 4096;
+
+  std::unordered_map<std::string, Value> variables;
+  // Variables of a loaded snapshot that have not been used yet.
+  std::unordered_map<std::string, StoredVariable> storedVariables;
+  std::unordered_map<std::string, std::shared_ptr<const Program>> programCache;
+  std::vector<Value> registers;
+  std::vector<const Value *> fusedValues;
+  Value lastResult;
   bool shouldPrint = true;
+  gemm::Algorithm matMulAlgorithm = gemm::Algorithm::STANDARD;
+  bool modified = false; // A variable was set since construction
+  std::chrono::steady_clock::time_point deadline = NO_DEADLINE;
 
-  auto evaluate(const std::shared_ptr<Expression> &expr) -> Matrix<double>;
-  auto evaluateBinary(const BinaryExpr *expr) -> Matrix<double>;
-  static auto evaluateLiteral(const LiteralExpr *expr) -> Matrix<double>;
-  auto evaluateVariable(const VariableExpr *expr) -> Matrix<double>;
-  auto evaluateAssign(const AssignExpr *expr) -> Matrix<double>;
+  void run(const Program &program);
+  void runFused(const Program &program, const Instruction &ins);
+  template <typename T>
+  void runFusedAs(const Program &program, const Instruction &ins);
+  auto runChain(const Instruction &ins) -> uint64_t;
+  auto runCall(const Program &program, const BuiltinCall &call) -> Value;
+  auto lookup(const std::string &name) -> const Value &;
+  auto find(const std::string &name) -> Value *;
+  void store(const std::string &name, Value value);
 
 public:
-  Interpreter() { variables["ans"] = Matrix<double>(1, 1); }
+  Interpreter() { variables["ans"] = 0.0; }
 
   auto interpret(const std::shared_ptr<Expression> &expression,
-                 bool printResult = true) -> Matrix<double>;
-  void setVariable(const std::string &name, const Matrix<double> &value);
-  auto getVariable(const std::string &name) -> Matrix<double>;
-  auto getLastResult() const -> Matrix<double> { return lastResult; }
+                 bool printResult = true) -> Value;
+
+  /**
+   * @brief Lex, parse and compile a statement, reusing a cached program.
+   *
+   * A statement ending with ';' compiles to a program that does not print.
+   *
+   * @param source Statement text.
+   * @return std::shared_ptr<const Program> The compiled program.
+   */
+  auto compile(const std::string &source) -> std::shared_ptr<const Program>;
+
+  /**
+   * @brief Run a compiled program against the current variables.
+   *
+   * Variable reads, 'ans' and the returned result share the stored matrices'
+   * buffers instead of copying them.
+   *
+   * @param program Program to run.
+   * @return Value Value of the statement, also stored in 'ans' unless the
+   * statement calls a builtin without a result.
+   */
+  auto execute(const Program &program) -> Value;
+
+  void setVariable(const std::string &name, Value value);
+  auto getVariable(const std::string &name) -> Value;
+  auto getLastResult() const -> Value { return lastResult; }
+
+  /**
+   * @brief Choose the algorithm for large square matrix products.
+   *
+   * @param algorithm Algorithm used by '*', see Matrix::multiply().
+   */
+  void setMatMulAlgorithm(gemm::Algorithm algorithm) {
+    matMulAlgorithm = algorithm;
+  }
+
+  [[nodiscard]] auto getMatMulAlgorithm() const -> gemm::Algorithm {
+    return matMulAlgorithm;
+  }
+
+  static constexpr std::chrono::steady_clock::time_point NO_DEADLINE =
+      std::chrono::steady_clock::time_point::max();
+
+  /**
+   * @brief Abort statements still running after a point in time.
+   *
+   * The deadline is checked before every instruction, so an instruction
+   * that has started, such as one large product, runs to completion.
+   *
+   * @param time Deadline, or NO_DEADLINE to run without one.
+   */
+  void setDeadline(std::chrono::steady_clock::time_point time) {
+    deadline = time;
+  }
+
+  /**
+   * @brief Write all variables, including 'ans', to a snapshot file.
+   *
+   * Every variable keeps its element type; sparse ones are stored in CSR
+   * form.
+   *
+   * @param path Path of the snapshot.
+   */
+  void saveWorkspace(const std::string &path);
+
+  /**
+   * @brief Restore the variables of a snapshot file.
+   *
+   * Only the index is read: each variable is mapped from the file when it is
+   * first used. Restored variables replace existing ones of the same name.
+   *
+   * @param path Path of the snapshot.
+   */
+  void loadWorkspace(const std::string &path);
+
+  /**
+   * @brief Whether any variable, including 'ans', was assigned or updated
+   * since construction.
+   *
+   * Calling loadWorkspace() does not count, but the loadws builtin does, so
+   * a session that only read a snapshot it was started from need not write
+   * it back.
+   *
+   * @return bool True if saving could change the snapshot.
+   */
+  [[nodiscard]] auto isModified() const -> bool { return modified; }
 };
 
 #endif // INTERPRETER_H
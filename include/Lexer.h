@@ -2,14 +2,21 @@
 #define LEXER_H
 
 #include "Token.h"
-#include <string>
+#include <string_view>
 #include <vector>
 
+/**
+ * @brief Splits source text into tokens without copying it.
+ *
+ * The lexer works on a view of the source, and token lexemes are views into
+ * the same text, so the source must stay alive while the tokens are in use.
+ */
 class Lexer {
 private:
-  std::string input;
+  std::string_view input;
   size_t current = 0;
   size_t start = 0;
+  size_t line;
 
   [[nodiscard]] auto isAtEnd() const -> bool;
   auto advance() -> char;
@@ -19,13 +26,57 @@ private:
   void skipWhitespace();
   auto number() -> Token;
   auto identifier() -> Token;
+  auto string() -> Token;
+  [[nodiscard]] auto make(TokenType type) const -> Token;
   [[nodiscard]] static auto isDigit(char c) -> bool;
   [[nodiscard]] static auto isAlpha(char c) -> bool;
   [[nodiscard]] static auto isAlphaNumeric(char c) -> bool;
 
 public:
-  explicit Lexer(std::string input) : input(std::move(input)) {}
+  /**
+   * @brief Constructor.
+   *
+   * @param input Source text.
+   * @param firstLine Line number of the first line of input.
+   */
+  explicit Lexer(std::string_view input, size_t firstLine = 1)
+      : input(input), line(firstLine) {}
+
+  /**
+   * @brief Scan the whole input.
+   *
+   * @return std::vector<Token> The tokens, terminated by END.
+   * @throws std::runtime_error on an unexpected character.
+   */
   auto scanTokens() -> std::vector<Token>;
+
+  /**
+   * @brief Scan the whole input, keeping unexpected characters as ERROR
+   * tokens so the parser can report them and carry on.
+   *
+   * @return std::vector<Token> The tokens, terminated by END.
+   */
+  auto scanProgram() -> std::vector<Token>;
+
+  /**
+   * @brief Scan an unsigned decimal number, digits[.digits][e[+-]digits],
+   * and convert it with std::from_chars.
+   *
+   * Shared by the lexer and the bulk text importers.
+   *
+   * @param first Start of the text.
+   * @param last End of the text.
+   * @param value Receives the number.
+   * @return const char* End of the number, or nullptr if there is none.
+   */
+  static auto scanNumber(const char *first, const char *last, double &value)
+      -> const char *;
+
+  /**
+   * @brief Scan the next token; an unexpected character yields ERROR.
+   *
+   * @return Token The token.
+   */
   auto scanToken() -> Token;
 };
 
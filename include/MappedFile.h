@@ -0,0 +1,48 @@
+#ifndef MAPPED_FILE_H
+#define MAPPED_FILE_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * @brief A whole file mapped into memory.
+ *
+ * The mapping is private and writable, but writes only touch private copies
+ * of the affected pages and never reach the file. Pages are read from disk
+ * on first access, so mapping even a very large file is cheap.
+ */
+class MappedFile {
+public:
+  /**
+   * @brief Map a file.
+   *
+   * @param path Path of the file.
+   * @throws std::runtime_error if the file cannot be opened or mapped.
+   */
+  explicit MappedFile(const std::string &path);
+
+  MappedFile(const MappedFile &) = delete;
+  auto operator=(const MappedFile &) -> MappedFile & = delete;
+
+  ~MappedFile();
+
+  /**
+   * @brief Start of the mapping, aligned to a page.
+   *
+   * @return std::byte* Pointer to the first byte, or nullptr if empty.
+   */
+  [[nodiscard]] auto data() const -> std::byte * { return bytes; }
+
+  /**
+   * @brief Size of the file in bytes.
+   *
+   * @return size_t Number of mapped bytes.
+   */
+  [[nodiscard]] auto size() const -> size_t { return length; }
+
+private:
+  std::byte *bytes = nullptr;
+  size_t length = 0;
+};
+
+#endif // MAPPED_FILE_H
@@ -1,27 +1,57 @@
 #ifndef MATRIX_H
 #define MATRIX_H
 
+#include "AlignedAllocator.h"
+#include "MatrixExpr.h"
+#include "Simd.h"
+#include "Strassen.h"
+#include <algorithm>
+#include <cmath>
 #include <iomanip>
 #include <iostream>
+#include <limits>
+#include <memory>
 #include <stdexcept>
+#include <string>
+#include <type_traits>
 #include <vector>
 
 /**
  * @brief A class for a 2D matrix.
  *
+ * Elements are stored in a single contiguous, 64-byte aligned, row-major
+ * buffer. Element (i, j) lives at offset i * stride + j, where the stride is
+ * the distance in elements between the starts of two consecutive rows.
+ *
+ * The buffer is reference counted and copy-on-write: copying a Matrix is O(1)
+ * and shares the buffer, and the first mutable access through a copy that is
+ * still shared (non-const operator(), raw(), rowPtr() or a compound
+ * assignment) gives it a private buffer first. Read-only access never copies.
+ * As with any copy-on-write type, a reference obtained from a mutable
+ * accessor must not be kept across a later copy of the matrix.
+ *
+ * Element-wise arithmetic (+, - and scaling) returns lazy expressions, see
+ * MatrixExpr, that are fused into a single pass when assigned to a Matrix.
+ * Matrix products are evaluated eagerly.
+ *
  * @tparam T Type of the elements.
  */
-template <typename T> class Matrix {
+template <typename T> class Matrix : public MatrixExpr<Matrix<T>> {
+public:
+  using Scalar = T;
+  using Storage = std::vector<T, AlignedAllocator<T>>;
+
 private:
-  std::vector<std::vector<T>> data;
   size_t rows;
   size_t cols;
+  size_t stride;
+  std::shared_ptr<T> buffer;
 
 public:
   /**
    * @brief Default constructor.
    */
-  Matrix() : rows(0), cols(0) {}
+  Matrix() : rows(0), cols(0), stride(0) {}
 
   /**
    * @brief Constructor with dimensions.
@@ -30,7 +60,9 @@ public:
    * @param cols Number of columns.
    */
   Matrix(size_t rows, size_t cols)
-      : rows(rows), cols(cols), data(rows, std::vector<T>(cols)) {}
+      : rows(rows), cols(cols), stride(cols), buffer(allocate(rows * cols)) {
+    std::fill_n(buffer.get(), rows * cols, T());
+  }
 
   /**
    * @brief Constructor with initializer list.
@@ -38,16 +70,15 @@ public:
    * @param list Initializer list to initialize the matrix.
    */
   Matrix(std::initializer_list<std::initializer_list<T>> list)
-      : rows(list.size()), cols(list.begin()->size()) {
+      : rows(list.size()), cols(list.size() == 0 ? 0 : list.begin()->size()),
+        stride(cols), buffer(allocate(rows * cols)) {
 
-    data.resize(rows);
-    size_t rowIdx = 0;
+    T *out = buffer.get();
     for (const auto &row : list) {
       if (row.size() != cols) {
         throw std::invalid_argument("Invalid number of columns");
       }
-      data[rowIdx] = row;
-      ++rowIdx;
+      out = std::copy(row.begin(), row.end(), out);
     }
   }
 
@@ -57,7 +88,145 @@ public:
    * @param vec Vector of vectors to initialize the matrix.
    */
   Matrix(const std::vector<std::vector<T>> &vec)
-      : rows(vec.size()), cols(vec.empty() ? 0 : vec[0].size()), data(vec) {}
+      : rows(vec.size()), cols(vec.empty() ? 0 : vec[0].size()), stride(cols),
+        buffer(allocate(rows * cols)) {
+
+    T *out = buffer.get();
+    for (const auto &row : vec) {
+      if (row.size() != cols) {
+        throw std::invalid_argument("Invalid number of columns");
+      }
+      out = std::copy(row.begin(), row.end(), out);
+    }
+  }
+
+  /**
+   * @brief Constructor from a flat row-major array.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param values Pointer to rows * cols elements in row-major order.
+   */
+  Matrix(size_t rows, size_t cols, const T *values)
+      : rows(rows), cols(cols), stride(cols), buffer(allocate(rows * cols)) {
+    std::copy(values, values + rows * cols, buffer.get());
+  }
+
+  /**
+   * @brief Constructor adopting an aligned row-major buffer without copying.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param values rows * cols elements in row-major order.
+   * @throws std::invalid_argument if the element count does not match.
+   */
+  Matrix(size_t rows, size_t cols, Storage &&values)
+      : rows(rows), cols(cols), stride(cols) {
+    if (values.size() != rows * cols) {
+      throw std::invalid_argument("Invalid number of elements");
+    }
+    if (!values.empty()) {
+      auto owner = std::make_shared<Storage>(std::move(values));
+      buffer = std::shared_ptr<T>(owner, owner->data());
+    }
+  }
+
+  /**
+   * @brief Constructor sharing a buffer owned elsewhere, such as a mapped
+   * file.
+   *
+   * The buffer must hold rows * cols elements in row-major order, aligned to
+   * MATRIX_ALIGNMENT, and stay writable for as long as it is referenced;
+   * it is copied before the first write only while it is shared.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param values The buffer, typically an aliasing pointer to its owner.
+   */
+  Matrix(size_t rows, size_t cols, std::shared_ptr<T> values)
+      : rows(rows), cols(cols), stride(cols), buffer(std::move(values)) {}
+
+  /**
+   * @brief Constructor evaluating an element-wise expression in one pass.
+   *
+   * @param expression Expression to evaluate.
+   */
+  template <typename E>
+  Matrix(const MatrixExpr<E> &expression)
+      : rows(expression.derived().getRows()),
+        cols(expression.derived().getCols()), stride(cols),
+        buffer(allocate(rows * cols)) {
+    assign(expression.derived());
+  }
+
+  Matrix(const Matrix<T> &other) = default;
+  Matrix(Matrix<T> &&other) noexcept = default;
+  auto operator=(const Matrix<T> &other) -> Matrix<T> & = default;
+  auto operator=(Matrix<T> &&other) noexcept -> Matrix<T> & = default;
+  ~Matrix() = default;
+
+  /**
+   * @brief Assign an element-wise expression.
+   *
+   * Evaluated in place when the shape is unchanged and the buffer is not
+   * shared, which is safe even if the expression reads this matrix.
+   *
+   * @param expression Expression to evaluate.
+   * @return Matrix<T>& This matrix.
+   */
+  template <typename E>
+  auto operator=(const MatrixExpr<E> &expression) -> Matrix<T> & {
+    const E &e = expression.derived();
+    if (e.getRows() == rows && e.getCols() == cols && !isShared()) {
+      assign(e);
+    } else {
+      *this = Matrix<T>(expression);
+    }
+    return *this;
+  }
+
+  /**
+   * @brief Create a matrix whose elements are left uninitialized.
+   *
+   * For callers that overwrite every element anyway.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @return Matrix<T> The new matrix.
+   */
+  static auto uninitialized(size_t rows, size_t cols) -> Matrix<T> {
+    Matrix<T> result;
+    result.rows = rows;
+    result.cols = cols;
+    result.stride = cols;
+    result.buffer = allocate(rows * cols);
+    return result;
+  }
+
+  /**
+   * @brief Copy the matrix with another element type.
+   *
+   * Floating-point values converted to an integer type are rounded to the
+   * nearest integer and saturated to its range; NaN becomes zero.
+   *
+   * @tparam U Element type of the result.
+   * @return Matrix<U> The converted matrix, sharing the buffer if U is T.
+   */
+  template <typename U> [[nodiscard]] auto cast() const -> Matrix<U> {
+    if constexpr (std::is_same_v<U, T>) {
+      return *this;
+    } else {
+      Matrix<U> result = Matrix<U>::uninitialized(rows, cols);
+      U *out = result.raw();
+      for (size_t i = 0; i < rows; ++i) {
+        const T *row = rowPtr(i);
+        for (size_t j = 0; j < cols; ++j) {
+          *out++ = convert<U>(row[j]);
+        }
+      }
+      return result;
+    }
+  }
 
   /**
    * @brief Access element at specified position.
@@ -71,7 +240,8 @@ public:
     if (row >= rows || col >= cols) {
       throw std::out_of_range("Matrix index out of range");
     }
-    return data[row][col];
+    detach();
+    return buffer.get()[row * stride + col];
   }
 
   /**
@@ -86,7 +256,7 @@ public:
     if (row >= rows || col >= cols) {
       throw std::out_of_range("Matrix index out of range");
     }
-    return data[row][col];
+    return buffer.get()[row * stride + col];
   }
 
   /**
@@ -103,52 +273,88 @@ public:
    */
   [[nodiscard]] auto getCols() const -> size_t { return cols; }
 
-  auto operator+(const Matrix<T> &other) const -> Matrix<T> {
-    if (rows != other.rows || cols != other.cols) {
-      throw std::invalid_argument("Matrix dimensions must match for addition");
-    }
-    Matrix<T> result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < cols; ++j) {
-        result(i, j) = data[i][j] + other(i, j);
-      }
-    }
-    return result;
+  /**
+   * @brief Get the row stride in elements.
+   *
+   * @return size_t Distance between the starts of two consecutive rows.
+   */
+  [[nodiscard]] auto getStride() const -> size_t { return stride; }
+
+  /**
+   * @brief Get the total number of elements.
+   *
+   * @return size_t rows * cols.
+   */
+  [[nodiscard]] auto size() const -> size_t { return rows * cols; }
+
+  /**
+   * @brief Whether the buffer is shared with another Matrix.
+   *
+   * @return bool True if a mutable access would copy the buffer.
+   */
+  [[nodiscard]] auto isShared() const -> bool {
+    return buffer && buffer.use_count() > 1;
   }
 
-  auto operator-(const Matrix<T> &other) const -> Matrix<T> {
-    if (rows != other.rows || cols != other.cols) {
-      throw std::invalid_argument(
-          "Matrix dimensions must match for subtraction");
-    }
-    Matrix<T> result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < cols; ++j) {
-        result(i, j) = data[i][j] - other(i, j);
-      }
-    }
-    return result;
+  /**
+   * @brief Raw pointer to the first element of the aligned buffer.
+   *
+   * @return T* Pointer to element (0, 0).
+   */
+  auto raw() -> T * {
+    detach();
+    return buffer.get();
+  }
+
+  /**
+   * @brief Raw pointer to the first element (const version).
+   *
+   * @return const T* Pointer to element (0, 0).
+   */
+  [[nodiscard]] auto raw() const -> const T * { return buffer.get(); }
+
+  /**
+   * @brief Raw pointer to the first element of a row, without bounds checks.
+   *
+   * @param row Row index.
+   * @return T* Pointer to element (row, 0).
+   */
+  auto rowPtr(size_t row) -> T * { return raw() + row * stride; }
+
+  /**
+   * @brief Raw pointer to the first element of a row (const version).
+   *
+   * @param row Row index.
+   * @return const T* Pointer to element (row, 0).
+   */
+  [[nodiscard]] auto rowPtr(size_t row) const -> const T * {
+    return buffer.get() + row * stride;
   }
 
   auto operator*(const Matrix<T> &other) const -> Matrix<T> {
+    return multiply(other, gemm::Algorithm::STANDARD);
+  }
+
+  /**
+   * @brief Matrix product with a choice of algorithm.
+   *
+   * gemm::Algorithm::STRASSEN only changes square floating-point products
+   * larger than gemm::STRASSEN_CROSSOVER; see gemm::strassen() for its error
+   * bound. Other products, and 1x1 operands, behave as operator*.
+   *
+   * @param other Right operand.
+   * @param algorithm Algorithm for large square products.
+   * @return Matrix<T> The product.
+   * @throws std::invalid_argument if the inner dimensions differ.
+   */
+  auto multiply(const Matrix<T> &other, gemm::Algorithm algorithm) const
+      -> Matrix<T> {
     // If the matrix or the other is a scalar
     if (cols == 1 && rows == 1) {
-      Matrix<T> result(other.rows, other.cols);
-      for (size_t i = 0; i < other.rows; ++i) {
-        for (size_t j = 0; j < other.cols; ++j) {
-          result(i, j) = data[0][0] * other(i, j);
-        }
-      }
-      return result;
+      return other * buffer.get()[0];
     }
     if (other.cols == 1 && other.rows == 1) {
-      Matrix<T> result(rows, cols);
-      for (size_t i = 0; i < rows; ++i) {
-        for (size_t j = 0; j < cols; ++j) {
-          result(i, j) = data[i][j] * other(0, 0);
-        }
-      }
-      return result;
+      return *this * other.buffer.get()[0];
     }
 
     if (cols != other.rows) {
@@ -156,69 +362,66 @@ public:
           "Matrix dimensions must match for multiplication");
     }
     Matrix<T> result(rows, other.cols);
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < other.cols; ++j) {
-        result(i, j) = 0;
-        for (size_t k = 0; k < cols; ++k) {
-          result(i, j) += data[i][k] * other(k, j);
-        }
-      }
-    }
-    return result;
-  }
-
-  auto operator*(T scalar) const -> Matrix<T> {
-    Matrix<T> result(rows, cols);
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < cols; ++j) {
-        result(i, j) = data[i][j] * scalar;
-      }
+    if (std::is_floating_point_v<T> && algorithm == gemm::Algorithm::STRASSEN &&
+        rows == cols && cols == other.cols) {
+      gemm::strassen(rows, raw(), stride, other.raw(), other.stride,
+                     result.raw(), result.stride);
+      return result;
     }
+    gemm::multiply(rows, other.cols, cols, raw(), stride, other.raw(),
+                   other.stride, result.raw(), result.stride);
     return result;
   }
 
-  // Left scalar multiplication
-  friend auto operator*(T scalar, const Matrix<T> &matrix) -> Matrix<T> {
-    return matrix * scalar;
-  }
-
   // Scalar multiplication assignment
   auto operator*=(T scalar) -> Matrix<T> & {
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < cols; ++j) {
-        data[i][j] *= scalar;
-      }
-    }
+    T *out = raw();
+    simd::broadcast(simd::Op::MUL, out, scalar, out, size());
     return *this;
   }
 
   // Matrix addition assignment
   auto operator+=(const Matrix<T> &other) -> Matrix<T> & {
     validateDimensions(other, "addition");
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < cols; ++j) {
-        data[i][j] += other(i, j);
-      }
-    }
+    T *out = raw();
+    simd::binary(simd::Op::ADD, out, other.raw(), out, size());
     return *this;
   }
 
   // Matrix subtraction assignment
   auto operator-=(const Matrix<T> &other) -> Matrix<T> & {
     validateDimensions(other, "subtraction");
-    for (size_t i = 0; i < rows; ++i) {
-      for (size_t j = 0; j < cols; ++j) {
-        data[i][j] -= other(i, j);
-      }
-    }
+    T *out = raw();
+    simd::binary(simd::Op::SUB, out, other.raw(), out, size());
     return *this;
   }
 
+  // Fused addition assignment of an expression
+  template <typename E>
+  auto operator+=(const MatrixExpr<E> &expression) -> Matrix<T> & {
+    return *this = *this + expression;
+  }
+
+  // Fused subtraction assignment of an expression
+  template <typename E>
+  auto operator-=(const MatrixExpr<E> &expression) -> Matrix<T> & {
+    return *this = *this - expression;
+  }
+
+  /**
+   * @brief Expression interface: the matrix's own elements.
+   */
+  auto evalChunk(size_t offset, size_t /*n*/, T * /*out*/,
+                 simd::Store /*store*/) const -> const T * {
+    return raw() + offset;
+  }
+
   friend auto operator<<(std::ostream &os, const Matrix<T> &matrix)
       -> std::ostream & {
     for (size_t i = 0; i < matrix.rows; ++i) {
+      const T *row = matrix.rowPtr(i);
       for (size_t j = 0; j < matrix.cols; ++j) {
-        os << std::setw(8) << matrix(i, j);
+        os << std::setw(8) << row[j];
       }
       os << '\n';
     }
@@ -226,6 +429,83 @@ public:
   }
 
 private:
+  /**
+   * @brief Convert one element for cast().
+   */
+  template <typename U> static auto convert(T value) -> U {
+    if constexpr (std::is_integral_v<U> && std::is_floating_point_v<T>) {
+      if (std::isnan(value)) {
+        return U();
+      }
+      const T rounded = std::round(value);
+      if (rounded <= static_cast<T>(std::numeric_limits<U>::lowest())) {
+        return std::numeric_limits<U>::lowest();
+      }
+      if (rounded >= static_cast<T>(std::numeric_limits<U>::max())) {
+        return std::numeric_limits<U>::max();
+      }
+      return static_cast<U>(rounded);
+    } else {
+      return static_cast<U>(value);
+    }
+  }
+
+  /**
+   * @brief Frees a buffer obtained from allocate().
+   */
+  struct Release {
+    size_t count;
+    void operator()(T *p) const {
+      std::destroy_n(p, count);
+      AlignedAllocator<T>().deallocate(p, count);
+    }
+  };
+
+  /**
+   * @brief Allocate an aligned, default-initialized buffer of n elements.
+   */
+  static auto allocate(size_t n) -> std::shared_ptr<T> {
+    if (n == 0) {
+      return nullptr;
+    }
+    T *p = AlignedAllocator<T>().allocate(n);
+    std::uninitialized_default_construct_n(p, n);
+    return std::shared_ptr<T>(p, Release{n});
+  }
+
+  /**
+   * @brief Give this matrix a private copy of a shared buffer.
+   */
+  void detach() {
+    if (!isShared()) {
+      return;
+    }
+    std::shared_ptr<T> copy = allocate(rows * cols);
+    for (size_t i = 0; i < rows; ++i) {
+      std::copy_n(buffer.get() + i * stride, cols, copy.get() + i * cols);
+    }
+    buffer = std::move(copy);
+    stride = cols;
+  }
+
+  /**
+   * @brief Evaluate a same-shaped expression into this matrix, chunk by chunk.
+   */
+  template <typename E> void assign(const E &e) {
+    const size_t n = size();
+    const simd::Store store = n * sizeof(T) > simd::streamingThreshold()
+                                  ? simd::Store::STREAM
+                                  : simd::Store::CACHED;
+    T *out = raw();
+    for (size_t offset = 0; offset < n; offset += expr::CHUNK) {
+      const size_t len = std::min(expr::CHUNK, n - offset);
+      const T *values = e.evalChunk(offset, len, out + offset, store);
+      if (values != out + offset) {
+        std::copy(values, values + len, out + offset);
+      }
+    }
+  }
+
   void validateDimensions(const Matrix<T> &other,
                           const std::string &operation) const {
     if (rows != other.rows || cols != other.cols) {
@@ -235,4 +515,23 @@ private:
   }
 };
 
+/**
+ * @brief Matrix product involving at least one expression.
+ *
+ * Expression operands are materialized first; the product itself is always
+ * evaluated eagerly by Matrix::operator*.
+ */
+template <typename L, typename R>
+auto operator*(const MatrixExpr<L> &lhs, const MatrixExpr<R> &rhs)
+    -> Matrix<typename L::Scalar> {
+  using M = Matrix<typename L::Scalar>;
+  if constexpr (std::is_same_v<L, M>) {
+    return lhs.derived() * M(rhs);
+  } else if constexpr (std::is_same_v<R, M>) {
+    return M(lhs) * rhs.derived();
+  } else {
+    return M(lhs) * M(rhs);
+  }
+}
+
 #endif // MATRIX_H
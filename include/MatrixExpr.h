@@ -0,0 +1,154 @@
+#ifndef MATRIX_EXPR_H
+#define MATRIX_EXPR_H
+
+#include "AlignedAllocator.h"
+#include "Simd.h"
+#include <cstddef>
+#include <stdexcept>
+#include <string>
+
+template <typename T> class Matrix;
+
+/**
+ * @brief CRTP base for lazily evaluated element-wise matrix expressions.
+ *
+ * Element-wise operators on matrices build a tree of expression nodes instead
+ * of allocating a temporary per operator. The tree is evaluated when it is
+ * assigned to a Matrix, in one pass over the destination: the flat element
+ * range is walked in chunks of CHUNK elements, every node computes its chunk
+ * into a small stack buffer through the SIMD kernels, and only the root writes
+ * to the destination. Each input is therefore read once and the output is
+ * written once, however long the chain.
+ *
+ * Every expression type provides getRows(), getCols() and
+ * evalChunk(offset, n, out, store), which returns a pointer to the n values
+ * starting at flat index offset. Leaves return a pointer into their own
+ * storage; inner nodes write to out and return it.
+ *
+ * Nodes hold matrices by reference and sub-expressions by value, so an
+ * expression must be consumed within the full-expression that created it.
+ *
+ * @tparam Derived The concrete expression type.
+ */
+template <typename Derived> class MatrixExpr {
+public:
+  /**
+   * @brief Access the concrete expression.
+   *
+   * @return const Derived& This expression as its concrete type.
+   */
+  [[nodiscard]] auto derived() const -> const Derived & {
+    return static_cast<const Derived &>(*this);
+  }
+
+protected:
+  MatrixExpr() = default;
+};
+
+namespace expr {
+
+/**
+ * @brief Number of elements evaluated per chunk; two chunks per node fit in
+ * L1.
+ */
+constexpr size_t CHUNK = 256;
+
+/**
+ * @brief How a node stores an operand: matrices by reference, expression
+ * nodes by value.
+ */
+template <typename E> struct Nested {
+  using type = const E;
+};
+
+template <typename T> struct Nested<Matrix<T>> {
+  using type = const Matrix<T> &;
+};
+
+/**
+ * @brief Element-wise a op b of two same-shaped expressions.
+ */
+template <typename L, typename R, simd::Op O>
+class Binary : public MatrixExpr<Binary<L, R, O>> {
+public:
+  using Scalar = typename L::Scalar;
+
+  Binary(const L &lhs, const R &rhs) : lhs(lhs), rhs(rhs) {
+    if (lhs.getRows() != rhs.getRows() || lhs.getCols() != rhs.getCols()) {
+      throw std::invalid_argument(
+          std::string("Matrix dimensions must match for ") +
+          (O == simd::Op::ADD ? "addition" : "subtraction"));
+    }
+  }
+
+  [[nodiscard]] auto getRows() const -> size_t { return lhs.getRows(); }
+  [[nodiscard]] auto getCols() const -> size_t { return lhs.getCols(); }
+
+  auto evalChunk(size_t offset, size_t n, Scalar *out, simd::Store store) const
+      -> const Scalar * {
+    alignas(MATRIX_ALIGNMENT) Scalar left[CHUNK];
+    alignas(MATRIX_ALIGNMENT) Scalar right[CHUNK];
+    const Scalar *a = lhs.evalChunk(offset, n, left, simd::Store::CACHED);
+    const Scalar *b = rhs.evalChunk(offset, n, right, simd::Store::CACHED);
+    simd::binary(O, a, b, out, n, store);
+    return out;
+  }
+
+private:
+  typename Nested<L>::type lhs;
+  typename Nested<R>::type rhs;
+};
+
+/**
+ * @brief Element-wise e * s of an expression and a scalar.
+ */
+template <typename E> class Scaled : public MatrixExpr<Scaled<E>> {
+public:
+  using Scalar = typename E::Scalar;
+
+  Scaled(const E &inner, Scalar factor) : inner(inner), factor(factor) {}
+
+  [[nodiscard]] auto getRows() const -> size_t { return inner.getRows(); }
+  [[nodiscard]] auto getCols() const -> size_t { return inner.getCols(); }
+
+  auto evalChunk(size_t offset, size_t n, Scalar *out, simd::Store store) const
+      -> const Scalar * {
+    // A single child finishes reading its inputs before it writes, so it can
+    // use out as its buffer even when out aliases one of them.
+    const Scalar *a = inner.evalChunk(offset, n, out, simd::Store::CACHED);
+    simd::broadcast(simd::Op::MUL, a, factor, out, n, store);
+    return out;
+  }
+
+private:
+  typename Nested<E>::type inner;
+  Scalar factor;
+};
+
+} // namespace expr
+
+template <typename L, typename R>
+auto operator+(const MatrixExpr<L> &lhs, const MatrixExpr<R> &rhs)
+    -> expr::Binary<L, R, simd::Op::ADD> {
+  return {lhs.derived(), rhs.derived()};
+}
+
+template <typename L, typename R>
+auto operator-(const MatrixExpr<L> &lhs, const MatrixExpr<R> &rhs)
+    -> expr::Binary<L, R, simd::Op::SUB> {
+  return {lhs.derived(), rhs.derived()};
+}
+
+template <typename E>
+auto operator*(const MatrixExpr<E> &matrix, typename E::Scalar scalar)
+    -> expr::Scaled<E> {
+  return {matrix.derived(), scalar};
+}
+
+template <typename E>
+auto operator*(typename E::Scalar scalar, const MatrixExpr<E> &matrix)
+    -> expr::Scaled<E> {
+  return {matrix.derived(), scalar};
+}
+
+#endif // MATRIX_EXPR_H
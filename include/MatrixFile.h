@@ -0,0 +1,107 @@
+#ifndef MATRIX_FILE_H
+#define MATRIX_FILE_H
+
+#include "MappedFile.h"
+#include "Value.h"
+#include <cstdint>
+#include <memory>
+#include <ostream>
+#include <string>
+
+/**
+ * @brief Element type tag of a matrix file.
+ */
+enum class ElementType : uint8_t {
+  FLOAT64 = 1, // IEEE 754 double
+  FLOAT32 = 2, // IEEE 754 float
+  INT32 = 3    // Two's complement int32_t
+};
+
+/**
+ * @brief Storage layout of a matrix file.
+ */
+enum class MatrixLayout : uint8_t {
+  DENSE = 0, // Row-major elements
+  CSR = 1    // Compressed sparse rows
+};
+
+/**
+ * @brief Header of the binary matrix format.
+ *
+ * A dense matrix file is this 64-byte header followed, at dataOffset, by the
+ * elements in row-major order without padding. dataOffset is a multiple of
+ * MATRIX_ALIGNMENT, so a mapped file can be used as a matrix buffer as is.
+ * A CSR matrix has instead rows + 1 uint64_t row offsets, nonZeros uint64_t
+ * column indices and nonZeros float64 values at dataOffset, one array after
+ * the other, as in SparseMatrix. Integers and elements are stored
+ * little-endian. Version 1 files are always dense.
+ */
+struct MatrixFileHeader {
+  char magic[4];         // "NLMX"
+  uint16_t version;      // MATRIX_FILE_VERSION
+  ElementType type;      // Element type
+  MatrixLayout layout;   // Storage layout
+  uint64_t rows;         // Number of rows
+  uint64_t cols;         // Number of columns
+  uint64_t dataOffset;   // Offset of the first element from the header
+  uint64_t nonZeros;     // Stored entries of a CSR matrix, zero if dense
+  uint8_t reserved1[24]; // Zero
+};
+
+static_assert(sizeof(MatrixFileHeader) == 64, "Unexpected header layout");
+
+constexpr uint16_t MATRIX_FILE_VERSION = 2;
+
+/**
+ * @brief Map a matrix file and wrap its data without copying.
+ *
+ * The returned matrix shares the mapping: nothing is read until elements are
+ * accessed, and writing to the matrix copies it first only if it is shared,
+ * otherwise only the touched pages are copied by the kernel. The file itself
+ * is never modified.
+ *
+ * A CSR record is read into a sparse matrix, which copies its stored
+ * entries but never densifies them.
+ *
+ * @param path Path of the file.
+ * @return Value The matrix, in its stored element type; a 1x1 float64
+ * matrix is returned as a scalar.
+ * @throws std::runtime_error if the file cannot be read or is invalid.
+ */
+auto loadMatrix(const std::string &path) -> Value;
+
+/**
+ * @brief Wrap a matrix stored at some offset of a mapped file.
+ *
+ * @param file The mapping, kept alive by the returned matrix.
+ * @param offset Offset of the matrix header, a multiple of MATRIX_ALIGNMENT.
+ * @param name Name used in error messages.
+ * @return Value The matrix, as returned by loadMatrix().
+ * @throws std::runtime_error if the header or the size is invalid.
+ */
+auto mapMatrix(const std::shared_ptr<MappedFile> &file, size_t offset,
+               const std::string &name) -> Value;
+
+/**
+ * @brief Write a matrix in the binary format.
+ *
+ * @param value Matrix to write, tagged with its element type; a scalar is
+ * written as a 1x1 float64 matrix and a sparse matrix as a CSR record.
+ * @param path Path of the file, replaced if it exists.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void saveMatrix(const Value &value, const std::string &path);
+
+/**
+ * @brief Write a matrix in the binary format to a stream.
+ *
+ * The stream is assumed to be at an offset that is a multiple of
+ * MATRIX_ALIGNMENT.
+ *
+ * @param value Matrix to write, as for saveMatrix().
+ * @param out Destination stream.
+ * @return uint64_t Number of bytes written.
+ */
+auto writeMatrix(const Value &value, std::ostream &out) -> uint64_t;
+
+#endif // MATRIX_FILE_H
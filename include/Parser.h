@@ -1,57 +1,129 @@
 #ifndef PARSER_H
 #define PARSER_H
 
+#include "Arena.h"
 #include "Matrix.h"
 #include "Token.h"
+#include <cstdint>
 #include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 
+/**
+ * @brief Tag identifying the concrete type of an Expression node.
+ */
+enum class ExprKind : uint8_t {
+  LITERAL,  // Matrix literal
+  NUMBER,   // Scalar literal
+  VARIABLE, // Variable read
+  BINARY,   // Binary operator
+  ASSIGN,   // Assignment to a variable
+  STRING,   // String literal
+  CALL      // Function call
+};
+
+/**
+ * @brief Base of the syntax tree nodes.
+ *
+ * Nodes live in the Arena of the parse that created them and refer to their
+ * children and names by plain pointers and views into the same arena, so a
+ * tree is built without per-node reference counting and freed in one go.
+ * Nodes are trivially destructible, so the arena keeps no destructor for
+ * them; a literal's matrix is a separate arena object. Consumers switch on
+ * kind and static_cast to the concrete node.
+ */
 class Expression {
 public:
-  virtual ~Expression() = default;
+  const ExprKind kind;
+
+protected:
+  explicit Expression(ExprKind kind) : kind(kind) {}
+  ~Expression() = default;
 };
 
 class BinaryExpr : public Expression {
 public:
-  std::shared_ptr<Expression> left;
-  Token op;
-  std::shared_ptr<Expression> right;
+  Expression *left;
+  TokenType op;
+  Expression *right;
 
-  BinaryExpr(std::shared_ptr<Expression> left, Token op,
-             std::shared_ptr<Expression> right)
-      : left(std::move(left)), op(std::move(op)), right(std::move(right)) {}
+  BinaryExpr(Expression *left, TokenType op, Expression *right)
+      : Expression(ExprKind::BINARY), left(left), op(op), right(right) {}
 };
 
 class LiteralExpr : public Expression {
 public:
-  Matrix<double> value;
-  explicit LiteralExpr(Matrix<double> value) : value(std::move(value)) {}
+  const Matrix<double> &value; // Owned by the arena
+  explicit LiteralExpr(const Matrix<double> &value)
+      : Expression(ExprKind::LITERAL), value(value) {}
+};
+
+class NumberExpr : public Expression {
+public:
+  double value;
+  explicit NumberExpr(double value)
+      : Expression(ExprKind::NUMBER), value(value) {}
 };
 
 class VariableExpr : public Expression {
 public:
-  Token name;
-  explicit VariableExpr(Token name) : name(std::move(name)) {}
+  std::string_view name;
+  explicit VariableExpr(std::string_view name)
+      : Expression(ExprKind::VARIABLE), name(name) {}
 };
 
 class AssignExpr : public Expression {
 public:
-  Token name;
-  std::shared_ptr<Expression> value;
-  AssignExpr(Token name, std::shared_ptr<Expression> value)
-      : name(std::move(name)), value(std::move(value)) {}
+  std::string_view name;
+  Expression *value;
+  AssignExpr(std::string_view name, Expression *value)
+      : Expression(ExprKind::ASSIGN), name(name), value(value) {}
+};
+
+class StringExpr : public Expression {
+public:
+  std::string_view value;
+  explicit StringExpr(std::string_view value)
+      : Expression(ExprKind::STRING), value(value) {}
+};
+
+class CallExpr : public Expression {
+public:
+  std::string_view name;
+  Expression *const *arguments;
+  size_t argumentCount;
+  CallExpr(std::string_view name, Expression *const *arguments,
+           size_t argumentCount)
+      : Expression(ExprKind::CALL), name(name), arguments(arguments),
+        argumentCount(argumentCount) {}
+};
+
+/**
+ * @brief One statement of a program.
+ *
+ * A statement that failed to parse has no expression and carries the error
+ * message instead.
+ */
+struct Statement {
+  std::shared_ptr<Expression> expression;
+  size_t line;
+  bool printResult;
+  std::string error;
 };
 
 class Parser {
 private:
   std::vector<Token> tokens;
   size_t current = 0;
+  Arena *arena = nullptr;
 
-  auto expression() -> std::shared_ptr<Expression>;
-  auto assignment() -> std::shared_ptr<Expression>;
-  auto term() -> std::shared_ptr<Expression>;
-  auto factor() -> std::shared_ptr<Expression>;
-  auto primary() -> std::shared_ptr<Expression>;
+  auto expression() -> Expression *;
+  auto assignment() -> Expression *;
+  auto term() -> Expression *;
+  auto factor() -> Expression *;
+  auto primary() -> Expression *;
+  auto call(std::string_view name) -> Expression *;
   auto parseMatrix() -> Matrix<double>;
 
   auto match(TokenType type) -> bool;
@@ -61,10 +133,29 @@ private:
   [[nodiscard]] auto previous() const -> Token;
   [[nodiscard]] auto isAtEnd() const -> bool;
   void consume(TokenType type, const std::string &message);
+  void synchronize();
 
 public:
   explicit Parser(std::vector<Token> tokens) : tokens(std::move(tokens)) {}
+
+  /**
+   * @brief Parse one expression statement into a fresh arena.
+   *
+   * @return std::shared_ptr<Expression> Root of the tree; it owns the arena,
+   * so the whole tree is released with the last reference to the root.
+   */
   auto parse() -> std::shared_ptr<Expression>;
+
+  /**
+   * @brief Parse a sequence of statements separated by newlines or ';'.
+   *
+   * A statement terminated by ';' does not print its value. A statement that
+   * fails to parse is recorded with its error, and parsing resumes on the
+   * next line. All statements share one arena.
+   *
+   * @return std::vector<Statement> The statements in source order.
+   */
+  auto parseProgram() -> std::vector<Statement>;
 };
 
 #endif // PARSER_H
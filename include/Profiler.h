@@ -0,0 +1,178 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * @brief Process-wide, low-overhead instrumentation of the interpreter.
+ *
+ * Time, bytes allocated and floating-point operations are accumulated per
+ * phase of a statement and per kind of VM operation. While disabled, a Scope
+ * costs a single relaxed atomic load; while enabled, it reads the clock twice.
+ *
+ * Bytes are those requested from AlignedAllocator by any thread while a
+ * scope is open, so they include temporaries freed before the scope ends.
+ * Scopes themselves must only be opened on the interpreter's thread.
+ */
+class Profiler {
+public:
+  /**
+   * @brief Stages a statement goes through.
+   */
+  enum class Phase : uint8_t { LEX, PARSE, COMPILE, EVAL, PRINT };
+
+  /**
+   * @brief Kinds of VM operation, see OpCode.
+   */
+  enum class Operation : uint8_t {
+    LOAD,        // LOAD_CONST and LOAD_VAR
+    STORE,       // STORE_VAR
+    ELEMENTWISE, // FUSED
+    MULTIPLY,    // MUL
+    CALL         // CALL
+  };
+
+  static constexpr size_t PHASE_COUNT = 5;
+  static constexpr size_t OPERATION_COUNT = 5;
+
+  /**
+   * @brief Totals for one phase or operation.
+   */
+  struct Counters {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+    uint64_t bytes = 0;
+    uint64_t flops = 0;
+  };
+
+  /**
+   * @brief Times the enclosing block and adds it to a phase or operation.
+   */
+  class Scope {
+  public:
+    explicit Scope(Phase phase)
+        : Scope(instance().phaseCounters(static_cast<size_t>(phase))) {}
+    explicit Scope(Operation operation)
+        : Scope(instance().operationCounters(static_cast<size_t>(operation))) {
+    }
+
+    Scope(const Scope &) = delete;
+    auto operator=(const Scope &) -> Scope & = delete;
+
+    ~Scope() {
+      if (target != nullptr) {
+        finish();
+      }
+    }
+
+    /**
+     * @brief Whether the scope is recording, i.e. profiling was enabled.
+     *
+     * @return bool True if counters will be updated.
+     */
+    [[nodiscard]] auto active() const -> bool { return target != nullptr; }
+
+    /**
+     * @brief Count floating-point operations done in the scope.
+     *
+     * @param count Number of operations.
+     */
+    void addFlops(uint64_t count) { flops += count; }
+
+  private:
+    explicit Scope(Counters *counters);
+    void finish();
+
+    Counters *target;
+    std::chrono::steady_clock::time_point start;
+    uint64_t startBytes = 0;
+    uint64_t flops = 0;
+  };
+
+  Profiler(const Profiler &) = delete;
+  auto operator=(const Profiler &) -> Profiler & = delete;
+
+  /**
+   * @brief The profiler shared by the whole process.
+   *
+   * @return Profiler& The shared profiler.
+   */
+  static auto instance() -> Profiler & {
+    static Profiler profiler;
+    return profiler;
+  }
+
+  /**
+   * @brief Record an allocation, if profiling is enabled.
+   *
+   * @param bytes Size of the allocation.
+   */
+  static void countAllocation(size_t bytes) {
+    Profiler &profiler = instance();
+    if (profiler.enabled()) {
+      profiler.allocated.fetch_add(bytes, std::memory_order_relaxed);
+    }
+  }
+
+  /**
+   * @brief Start or stop collecting. Totals are kept either way.
+   *
+   * @param on True to collect.
+   */
+  void setEnabled(bool on) { active.store(on, std::memory_order_relaxed); }
+
+  [[nodiscard]] auto enabled() const -> bool {
+    return active.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Clear all totals.
+   */
+  void reset();
+
+  [[nodiscard]] auto phase(Phase phase) const -> const Counters & {
+    return phases[static_cast<size_t>(phase)];
+  }
+
+  [[nodiscard]] auto operation(Operation operation) const
+      -> const Counters & {
+    return operations[static_cast<size_t>(operation)];
+  }
+
+  /**
+   * @brief Print the totals as a table.
+   *
+   * @param out Stream to print to.
+   */
+  void report(std::ostream &out) const;
+
+  /**
+   * @brief Write the totals as a JSON object.
+   *
+   * @param out Stream to write to.
+   */
+  void writeJson(std::ostream &out) const;
+
+private:
+  Profiler() = default;
+
+  auto phaseCounters(size_t index) -> Counters * {
+    return enabled() ? &phases[index] : nullptr;
+  }
+
+  auto operationCounters(size_t index) -> Counters * {
+    return enabled() ? &operations[index] : nullptr;
+  }
+
+  std::atomic<bool> active{false};
+  std::atomic<uint64_t> allocated{0};
+  std::array<Counters, PHASE_COUNT> phases{};
+  std::array<Counters, OPERATION_COUNT> operations{};
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,61 @@
+#ifndef RUNNER_H
+#define RUNNER_H
+
+#include "Interpreter.h"
+#include <cstddef>
+#include <istream>
+#include <ostream>
+#include <string_view>
+
+/**
+ * @brief Runs whole scripts non-interactively.
+ *
+ * Input is consumed in batches of complete lines: each batch is lexed and
+ * parsed into a statement list in one go and then executed statement by
+ * statement. A statement that fails to parse or to execute is reported with
+ * its line number and the run continues with the next one. Results are
+ * written without prompts or explicit flushes.
+ */
+class Runner {
+public:
+  /**
+   * @brief Approximate number of bytes read and parsed per batch.
+   */
+  static constexpr size_t BATCH_BYTES = 1 << 20;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param interpreter Interpreter holding the variables.
+   * @param out Stream receiving printed results.
+   * @param err Stream receiving error reports.
+   */
+  Runner(Interpreter &interpreter, std::ostream &out, std::ostream &err)
+      : interpreter(interpreter), out(out), err(err) {}
+
+  /**
+   * @brief Run every statement read from a stream.
+   *
+   * @param in Script text.
+   * @return size_t Number of statements that failed.
+   */
+  auto run(std::istream &in) -> size_t;
+
+  /**
+   * @brief Run every statement of a piece of source text.
+   *
+   * @param source Script text made of complete lines.
+   * @param firstLine Line number of the first line of source.
+   * @return size_t Number of statements that failed.
+   */
+  auto run(std::string_view source, size_t firstLine = 1) -> size_t;
+
+private:
+  Interpreter &interpreter;
+  std::ostream &out;
+  std::ostream &err;
+
+  void report(size_t line, const char *message);
+};
+
+#endif // RUNNER_H
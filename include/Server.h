@@ -0,0 +1,106 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+/**
+ * @brief Limits and defaults of a Server.
+ */
+struct ServerOptions {
+  size_t workers = ThreadPool::defaultThreadCount(); // Evaluation threads
+  size_t maxSessions = 256; // Connections beyond this are refused
+  size_t maxPending = 16;   // Queued requests per session before reading stops
+  size_t maxRequestBytes = size_t(64) << 20; // Longest request line
+  std::chrono::nanoseconds timeout = std::chrono::seconds(30); // Zero: none
+  std::string workspace; // Snapshot every session starts from, if not empty
+};
+
+/**
+ * @brief Evaluation server hosting independent sessions on a Unix socket.
+ *
+ * Every connection is a session with its own Interpreter. A request is one
+ * line of statements, run as by Runner; the reply is a header line "OK n"
+ * or "ERR n" followed by n bytes: the printed results, or the error
+ * reports if any statement failed.
+ *
+ * One thread multiplexes the sockets with poll(); requests run on a pool of
+ * options.workers threads. A session's requests run one at a time in the
+ * order they arrived, and different sessions run concurrently. Once a
+ * session has options.maxPending requests queued, its socket is no longer
+ * read, so a client that sends faster than it is served blocks in its own
+ * writes. A request line longer than options.maxRequestBytes is answered
+ * with an error and closes the session. A request still queued or running
+ * options.timeout after it was read fails with "Time limit exceeded."; see
+ * Interpreter::setDeadline().
+ *
+ * Statements of different sessions only share the process-wide ThreadPool
+ * used by the kernels. The Profiler is not thread-safe and must stay
+ * disabled while serving.
+ */
+class Server {
+public:
+  /**
+   * @brief Bind and listen on a socket path, replacing a stale socket.
+   *
+   * @param path Path of the socket.
+   * @param options Limits of the server.
+   * @throws std::runtime_error if the socket cannot be created.
+   */
+  Server(std::string path, ServerOptions options = {});
+
+  Server(const Server &) = delete;
+  auto operator=(const Server &) -> Server & = delete;
+
+  /**
+   * @brief Close the socket and remove its path.
+   */
+  ~Server();
+
+  /**
+   * @brief Serve connections until stop() is called.
+   *
+   * Returns once the requests already read have been answered.
+   */
+  void run();
+
+  /**
+   * @brief Make run() return. Safe to call from a signal handler.
+   */
+  void stop();
+
+  /**
+   * @brief Number of open sessions.
+   *
+   * @return size_t Connected clients.
+   */
+  [[nodiscard]] auto sessionCount() const -> size_t { return sessions; }
+
+private:
+  struct Session;
+
+  std::string path;
+  ServerOptions options;
+  int listener = -1;
+  int wakeRead = -1;
+  int wakeWrite = -1;
+  std::atomic<bool> stopping{false};
+  std::atomic<size_t> sessions{0};
+  std::unordered_map<int, std::shared_ptr<Session>> connections;
+  ThreadPool *pool = nullptr; // Owned by run()
+
+  void serve();
+  void accept();
+  void read(const std::shared_ptr<Session> &session);
+  void dispatch(const std::shared_ptr<Session> &session, bool all = false);
+  void reject(const std::shared_ptr<Session> &session, std::string error);
+  void drain(const std::shared_ptr<Session> &session);
+  void wake();
+};
+
+#endif // SERVER_H
@@ -0,0 +1,473 @@
+#ifndef SIMD_H
+#define SIMD_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+#if defined(__x86_64__) || defined(__i386__)
+#if defined(__GNUC__) || defined(__clang__)
+#define NL_SIMD_X86 1
+#include <immintrin.h>
+#include <unistd.h>
+#endif
+#endif
+
+/**
+ * @brief Runtime-dispatched SIMD kernels for element-wise operations.
+ *
+ * Every kernel is compiled for SSE2, AVX2 and AVX-512 through function target
+ * attributes, and the widest level supported by the running CPU (queried with
+ * CPUID) is picked on first use, so a single binary runs on every host.
+ * Outputs larger than the last-level cache are written with non-temporal
+ * stores so they do not evict the inputs. Element types other than float and
+ * double, and non-x86 builds, use a plain loop; signed integers wrap around
+ * on overflow.
+ */
+namespace simd {
+
+/**
+ * @brief Instruction set levels, ordered from narrowest to widest.
+ */
+enum class Level { SCALAR, SSE2, AVX2, AVX512 };
+
+/**
+ * @brief Element-wise operations provided by the kernels.
+ */
+enum class Op { ADD, SUB, MUL };
+
+/**
+ * @brief Store policy for kernel outputs.
+ *
+ * AUTO streams outputs larger than streamingThreshold(); callers that write a
+ * large destination in pieces pass STREAM or CACHED explicitly.
+ */
+enum class Store { AUTO, CACHED, STREAM };
+
+/**
+ * @brief Widest level supported by the CPU.
+ *
+ * @return Level Detected level.
+ */
+inline auto detectLevel() -> Level {
+#ifdef NL_SIMD_X86
+  __builtin_cpu_init();
+  if (__builtin_cpu_supports("avx512f")) {
+    return Level::AVX512;
+  }
+  // The matrix product's AVX2 kernel also needs FMA, which every AVX2 CPU
+  // has.
+  if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma")) {
+    return Level::AVX2;
+  }
+  if (__builtin_cpu_supports("sse2")) {
+    return Level::SSE2;
+  }
+#endif
+  return Level::SCALAR;
+}
+
+namespace detail {
+
+inline auto activeLevel() -> std::atomic<Level> & {
+  static std::atomic<Level> level{detectLevel()};
+  return level;
+}
+
+inline auto streamingBytes() -> std::atomic<size_t> & {
+  static std::atomic<size_t> bytes{[]() -> size_t {
+    constexpr size_t FALLBACK = size_t(32) << 20;
+#if defined(NL_SIMD_X86) && defined(_SC_LEVEL3_CACHE_SIZE)
+    const long llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+    if (llc > 0) {
+      return static_cast<size_t>(llc);
+    }
+#endif
+    return FALLBACK;
+  }()};
+  return bytes;
+}
+
+template <typename T> auto applyScalar(Op op, T a, T b) -> T {
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    return static_cast<T>(
+        applyScalar(op, static_cast<U>(a), static_cast<U>(b)));
+  }
+  switch (op) {
+  case Op::ADD:
+    return a + b;
+  case Op::SUB:
+    return a - b;
+  case Op::MUL:
+    return a * b;
+  }
+  return a;
+}
+
+template <typename T>
+void binaryScalar(Op op, const T *a, const T *b, T *out, size_t n) {
+  // Signed integers wrap around, computed in their unsigned type.
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    binaryScalar(op, reinterpret_cast<const U *>(a),
+                 reinterpret_cast<const U *>(b), reinterpret_cast<U *>(out),
+                 n);
+    return;
+  }
+  switch (op) {
+  case Op::ADD:
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] + b[i];
+    }
+    break;
+  case Op::SUB:
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] - b[i];
+    }
+    break;
+  case Op::MUL:
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] * b[i];
+    }
+    break;
+  }
+}
+
+template <typename T>
+void broadcastScalar(Op op, const T *a, T s, T *out, size_t n) {
+  if constexpr (std::is_integral_v<T> && std::is_signed_v<T>) {
+    using U = std::make_unsigned_t<T>;
+    broadcastScalar(op, reinterpret_cast<const U *>(a), static_cast<U>(s),
+                    reinterpret_cast<U *>(out), n);
+    return;
+  }
+  switch (op) {
+  case Op::ADD:
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] + s;
+    }
+    break;
+  case Op::SUB:
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] - s;
+    }
+    break;
+  case Op::MUL:
+    for (size_t i = 0; i < n; ++i) {
+      out[i] = a[i] * s;
+    }
+    break;
+  }
+}
+
+#ifdef NL_SIMD_X86
+
+// Register traits: one struct per (instruction set, element type) exposing
+// the handful of intrinsics the loops below need.
+#define NL_SIMD_REGISTER(NAME, TARGET, TYPE, VEC, WIDTH, SFX, PFX)             \
+  struct NAME {                                                                \
+    using T = TYPE;                                                            \
+    using V = VEC;                                                             \
+    static constexpr size_t width = WIDTH;                                     \
+    TARGET static auto load(const T *p) -> V { return PFX##_loadu_##SFX(p); }  \
+    TARGET static void store(T *p, V v) { PFX##_storeu_##SFX(p, v); }          \
+    TARGET static void stream(T *p, V v) { PFX##_stream_##SFX(p, v); }         \
+    TARGET static auto set1(T s) -> V { return PFX##_set1_##SFX(s); }          \
+    TARGET static auto apply(Op op, V a, V b) -> V {                           \
+      switch (op) {                                                            \
+      case Op::ADD:                                                            \
+        return PFX##_add_##SFX(a, b);                                          \
+      case Op::SUB:                                                            \
+        return PFX##_sub_##SFX(a, b);                                          \
+      case Op::MUL:                                                            \
+        return PFX##_mul_##SFX(a, b);                                          \
+      }                                                                        \
+      return a;                                                                \
+    }                                                                          \
+  };
+
+// Loops shared by all instruction sets. The operation is a template argument
+// so the switch in apply() folds away. Non-temporal stores need an aligned
+// destination, so the streaming variant peels leading elements first.
+#define NL_SIMD_LOOPS(TARGET)                                                  \
+  template <typename R, Op op>                                                 \
+  TARGET void binaryLoop(const typename R::T *a, const typename R::T *b,       \
+                         typename R::T *out, size_t n, bool nonTemporal) {     \
+    constexpr size_t W = R::width;                                             \
+    size_t i = 0;                                                              \
+    if (nonTemporal) {                                                         \
+      for (; i < n && reinterpret_cast<uintptr_t>(out + i) %                   \
+                          (W * sizeof(typename R::T)) !=                       \
+                      0;                                                       \
+           ++i) {                                                              \
+        out[i] = applyScalar(op, a[i], b[i]);                                  \
+      }                                                                        \
+      for (; i + W <= n; i += W) {                                             \
+        R::stream(out + i, R::apply(op, R::load(a + i), R::load(b + i)));      \
+      }                                                                        \
+      _mm_sfence();                                                            \
+    } else {                                                                   \
+      for (; i + 2 * W <= n; i += 2 * W) {                                     \
+        auto x0 = R::apply(op, R::load(a + i), R::load(b + i));                \
+        auto x1 = R::apply(op, R::load(a + i + W), R::load(b + i + W));        \
+        R::store(out + i, x0);                                                 \
+        R::store(out + i + W, x1);                                             \
+      }                                                                        \
+      for (; i + W <= n; i += W) {                                             \
+        R::store(out + i, R::apply(op, R::load(a + i), R::load(b + i)));       \
+      }                                                                        \
+    }                                                                          \
+    for (; i < n; ++i) {                                                       \
+      out[i] = applyScalar(op, a[i], b[i]);                                    \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  template <typename R, Op op>                                                 \
+  TARGET void broadcastLoop(const typename R::T *a, typename R::T s,           \
+                            typename R::T *out, size_t n, bool nonTemporal) {  \
+    constexpr size_t W = R::width;                                             \
+    const auto vs = R::set1(s);                                                \
+    size_t i = 0;                                                              \
+    if (nonTemporal) {                                                         \
+      for (; i < n && reinterpret_cast<uintptr_t>(out + i) %                   \
+                          (W * sizeof(typename R::T)) !=                       \
+                      0;                                                       \
+           ++i) {                                                              \
+        out[i] = applyScalar(op, a[i], s);                                     \
+      }                                                                        \
+      for (; i + W <= n; i += W) {                                             \
+        R::stream(out + i, R::apply(op, R::load(a + i), vs));                  \
+      }                                                                        \
+      _mm_sfence();                                                            \
+    } else {                                                                   \
+      for (; i + 2 * W <= n; i += 2 * W) {                                     \
+        auto x0 = R::apply(op, R::load(a + i), vs);                            \
+        auto x1 = R::apply(op, R::load(a + i + W), vs);                        \
+        R::store(out + i, x0);                                                 \
+        R::store(out + i + W, x1);                                             \
+      }                                                                        \
+      for (; i + W <= n; i += W) {                                             \
+        R::store(out + i, R::apply(op, R::load(a + i), vs));                   \
+      }                                                                        \
+    }                                                                          \
+    for (; i < n; ++i) {                                                       \
+      out[i] = applyScalar(op, a[i], s);                                       \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  template <typename R>                                                        \
+  TARGET void binary(Op op, const typename R::T *a, const typename R::T *b,    \
+                     typename R::T *out, size_t n, bool nonTemporal) {         \
+    switch (op) {                                                              \
+    case Op::ADD:                                                              \
+      return binaryLoop<R, Op::ADD>(a, b, out, n, nonTemporal);                \
+    case Op::SUB:                                                              \
+      return binaryLoop<R, Op::SUB>(a, b, out, n, nonTemporal);                \
+    case Op::MUL:                                                              \
+      return binaryLoop<R, Op::MUL>(a, b, out, n, nonTemporal);                \
+    }                                                                          \
+  }                                                                            \
+                                                                               \
+  template <typename R>                                                        \
+  TARGET void broadcast(Op op, const typename R::T *a, typename R::T s,        \
+                        typename R::T *out, size_t n, bool nonTemporal) {      \
+    switch (op) {                                                              \
+    case Op::ADD:                                                              \
+      return broadcastLoop<R, Op::ADD>(a, s, out, n, nonTemporal);             \
+    case Op::SUB:                                                              \
+      return broadcastLoop<R, Op::SUB>(a, s, out, n, nonTemporal);             \
+    case Op::MUL:                                                              \
+      return broadcastLoop<R, Op::MUL>(a, s, out, n, nonTemporal);             \
+    }                                                                          \
+  }
+
+namespace sse2 {
+#define NL_TARGET_SSE2 __attribute__((target("sse2")))
+NL_SIMD_REGISTER(F64, NL_TARGET_SSE2, double, __m128d, 2, pd, _mm)
+NL_SIMD_REGISTER(F32, NL_TARGET_SSE2, float, __m128, 4, ps, _mm)
+NL_SIMD_LOOPS(NL_TARGET_SSE2)
+#undef NL_TARGET_SSE2
+} // namespace sse2
+
+namespace avx2 {
+#define NL_TARGET_AVX2 __attribute__((target("avx2")))
+NL_SIMD_REGISTER(F64, NL_TARGET_AVX2, double, __m256d, 4, pd, _mm256)
+NL_SIMD_REGISTER(F32, NL_TARGET_AVX2, float, __m256, 8, ps, _mm256)
+NL_SIMD_LOOPS(NL_TARGET_AVX2)
+#undef NL_TARGET_AVX2
+} // namespace avx2
+
+namespace avx512 {
+#define NL_TARGET_AVX512 __attribute__((target("avx512f")))
+NL_SIMD_REGISTER(F64, NL_TARGET_AVX512, double, __m512d, 8, pd, _mm512)
+NL_SIMD_REGISTER(F32, NL_TARGET_AVX512, float, __m512, 16, ps, _mm512)
+NL_SIMD_LOOPS(NL_TARGET_AVX512)
+#undef NL_TARGET_AVX512
+} // namespace avx512
+
+#undef NL_SIMD_LOOPS
+#undef NL_SIMD_REGISTER
+
+template <typename T> struct Registers;
+
+template <> struct Registers<double> {
+  using Sse2 = sse2::F64;
+  using Avx2 = avx2::F64;
+  using Avx512 = avx512::F64;
+};
+
+template <> struct Registers<float> {
+  using Sse2 = sse2::F32;
+  using Avx2 = avx2::F32;
+  using Avx512 = avx512::F32;
+};
+
+#endif // NL_SIMD_X86
+
+} // namespace detail
+
+/**
+ * @brief Get the level the kernels currently dispatch to.
+ *
+ * @return Level Active level.
+ */
+inline auto level() -> Level { return detail::activeLevel().load(); }
+
+/**
+ * @brief Restrict dispatch to a narrower level, e.g. for testing.
+ *
+ * Requests wider than the CPU supports are clamped to detectLevel().
+ *
+ * @param requested Level to dispatch to.
+ */
+inline void setLevel(Level requested) {
+  const Level supported = detectLevel();
+  detail::activeLevel() = requested > supported ? supported : requested;
+}
+
+/**
+ * @brief Output size in bytes above which non-temporal stores are used.
+ *
+ * Defaults to the size of the last-level cache.
+ *
+ * @return size_t Threshold in bytes.
+ */
+inline auto streamingThreshold() -> size_t {
+  return detail::streamingBytes().load();
+}
+
+/**
+ * @brief Override the non-temporal store threshold.
+ *
+ * @param bytes New threshold in bytes.
+ */
+inline void setStreamingThreshold(size_t bytes) {
+  detail::streamingBytes() = bytes;
+}
+
+namespace detail {
+
+template <typename T> auto nonTemporal(Store store, size_t n) -> bool {
+  switch (store) {
+  case Store::CACHED:
+    return false;
+  case Store::STREAM:
+    return true;
+  case Store::AUTO:
+    break;
+  }
+  return n * sizeof(T) > streamingThreshold();
+}
+
+} // namespace detail
+
+/**
+ * @brief a op b for a single pair of elements, as the kernels compute it.
+ */
+template <typename T> auto apply(Op op, T a, T b) -> T {
+  return detail::applyScalar(op, a, b);
+}
+
+/**
+ * @brief out[i] = a[i] op b[i].
+ *
+ * out may alias a or b exactly.
+ *
+ * @param op Operation.
+ * @param a First operand.
+ * @param b Second operand.
+ * @param out Destination.
+ * @param n Number of elements.
+ * @param store Store policy for out.
+ */
+template <typename T>
+void binary(Op op, const T *a, const T *b, T *out, size_t n,
+            Store store = Store::AUTO) {
+#ifdef NL_SIMD_X86
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    using R = detail::Registers<T>;
+    const bool nonTemporal = detail::nonTemporal<T>(store, n);
+    switch (level()) {
+    case Level::AVX512:
+      detail::avx512::binary<typename R::Avx512>(op, a, b, out, n,
+                                                 nonTemporal);
+      return;
+    case Level::AVX2:
+      detail::avx2::binary<typename R::Avx2>(op, a, b, out, n, nonTemporal);
+      return;
+    case Level::SSE2:
+      detail::sse2::binary<typename R::Sse2>(op, a, b, out, n, nonTemporal);
+      return;
+    case Level::SCALAR:
+      break;
+    }
+  }
+#endif
+  detail::binaryScalar(op, a, b, out, n);
+}
+
+/**
+ * @brief out[i] = a[i] op s.
+ *
+ * out may alias a exactly.
+ *
+ * @param op Operation.
+ * @param a Array operand.
+ * @param s Scalar operand.
+ * @param out Destination.
+ * @param n Number of elements.
+ * @param store Store policy for out.
+ */
+template <typename T>
+void broadcast(Op op, const T *a, T s, T *out, size_t n,
+               Store store = Store::AUTO) {
+#ifdef NL_SIMD_X86
+  if constexpr (std::is_same_v<T, double> || std::is_same_v<T, float>) {
+    using R = detail::Registers<T>;
+    const bool nonTemporal = detail::nonTemporal<T>(store, n);
+    switch (level()) {
+    case Level::AVX512:
+      detail::avx512::broadcast<typename R::Avx512>(op, a, s, out, n,
+                                                    nonTemporal);
+      return;
+    case Level::AVX2:
+      detail::avx2::broadcast<typename R::Avx2>(op, a, s, out, n,
+                                                nonTemporal);
+      return;
+    case Level::SSE2:
+      detail::sse2::broadcast<typename R::Sse2>(op, a, s, out, n,
+                                                nonTemporal);
+      return;
+    case Level::SCALAR:
+      break;
+    }
+  }
+#endif
+  detail::broadcastScalar(op, a, s, out, n);
+}
+
+} // namespace simd
+
+#endif // SIMD_H
@@ -0,0 +1,468 @@
+#ifndef SPARSE_MATRIX_H
+#define SPARSE_MATRIX_H
+
+#include "Matrix.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+#include <stdexcept>
+#include <vector>
+
+/**
+ * @brief A sparse matrix in compressed sparse row (CSR) form.
+ *
+ * Row i's non-zeros are values[offsets[i] .. offsets[i + 1]), in increasing
+ * column order, with their columns in the same range of columns. Only the
+ * stored entries are touched by the kernels, which split the rows into
+ * blocks of roughly equal work on the shared ThreadPool. transpose() gives
+ * the compressed sparse column (CSC) form.
+ *
+ * Entries are structural: a sum or product that cancels to zero stays
+ * stored. Conversion from a dense matrix stores only non-zero elements.
+ *
+ * @tparam T Type of the elements.
+ */
+template <typename T> class SparseMatrix {
+private:
+  size_t rows = 0;
+  size_t cols = 0;
+  std::vector<size_t> offsets;
+  std::vector<size_t> columns;
+  std::vector<T> values;
+
+  /**
+   * @brief Stored entries below which the kernels run on a single thread.
+   */
+  static constexpr size_t PARALLEL_THRESHOLD = 1 << 15;
+
+  /**
+   * @brief Run fn(begin, end) over blocks of rows covering [0, count).
+   *
+   * @param work Estimated total work, used to decide whether to split.
+   */
+  template <typename F>
+  static void forRowBlocks(size_t count, size_t work, F &&fn) {
+    ThreadPool &pool = ThreadPool::instance();
+    const size_t blocks =
+        work < PARALLEL_THRESHOLD
+            ? 1
+            : std::max<size_t>(1, std::min(count, pool.threadCount() * 4));
+    const size_t perBlock = (count + blocks - 1) / blocks;
+    pool.parallelFor(blocks, [&](size_t b) {
+      const size_t begin = b * perBlock;
+      const size_t end = std::min(count, begin + perBlock);
+      if (begin < end) {
+        fn(begin, end);
+      }
+    });
+  }
+
+  /**
+   * @brief Fill offsets from per-row counts stored in offsets[1 ..].
+   */
+  void accumulateOffsets() {
+    std::partial_sum(offsets.begin(), offsets.end(), offsets.begin());
+    columns.resize(offsets.back());
+    values.resize(offsets.back());
+  }
+
+  /**
+   * @brief Row-wise merge of this and other, with other scaled by sign.
+   *
+   * The result stores the union of both patterns; entries that cancel are
+   * kept as explicit zeros.
+   */
+  auto combine(const SparseMatrix<T> &other, T sign) const
+      -> SparseMatrix<T> {
+    if (rows != other.rows || cols != other.cols) {
+      throw std::invalid_argument(
+          "Matrix dimensions must match for addition/subtraction");
+    }
+    SparseMatrix<T> result(rows, cols);
+    // Two passes over the same merge: count each row, then fill it.
+    auto merge = [&](size_t i, bool fill) {
+      size_t p = offsets[i];
+      size_t q = other.offsets[i];
+      size_t out = fill ? result.offsets[i] : 0;
+      while (p < offsets[i + 1] || q < other.offsets[i + 1]) {
+        const size_t cp = p < offsets[i + 1] ? columns[p] : cols;
+        const size_t cq = q < other.offsets[i + 1] ? other.columns[q] : cols;
+        const size_t col = std::min(cp, cq);
+        if (fill) {
+          T value = T();
+          if (cp == col) {
+            value += values[p];
+          }
+          if (cq == col) {
+            value += sign * other.values[q];
+          }
+          result.columns[out] = col;
+          result.values[out] = value;
+        }
+        p += cp == col ? 1 : 0;
+        q += cq == col ? 1 : 0;
+        ++out;
+      }
+      return out;
+    };
+
+    const size_t work = nonZeros() + other.nonZeros();
+    forRowBlocks(rows, work, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        result.offsets[i + 1] = merge(i, false);
+      }
+    });
+    result.accumulateOffsets();
+    forRowBlocks(rows, work, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        merge(i, true);
+      }
+    });
+    return result;
+  }
+
+public:
+  /**
+   * @brief Default constructor: an empty 0 x 0 matrix.
+   */
+  SparseMatrix() : offsets(1, 0) {}
+
+  /**
+   * @brief Constructor for an all-zero matrix.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   */
+  SparseMatrix(size_t rows, size_t cols)
+      : rows(rows), cols(cols), offsets(rows + 1, 0) {}
+
+  /**
+   * @brief Constructor adopting CSR arrays.
+   *
+   * @param rows Number of rows.
+   * @param cols Number of columns.
+   * @param offsets rows + 1 non-decreasing offsets, starting at 0.
+   * @param columns Column of each entry, increasing within a row.
+   * @param values Value of each entry.
+   * @throws std::invalid_argument if the arrays are not a valid CSR matrix.
+   */
+  SparseMatrix(size_t rows, size_t cols, std::vector<size_t> offsets,
+               std::vector<size_t> columns, std::vector<T> values)
+      : rows(rows), cols(cols), offsets(std::move(offsets)),
+        columns(std::move(columns)), values(std::move(values)) {
+    bool valid = this->offsets.size() == rows + 1 &&
+                 this->offsets.front() == 0 &&
+                 this->offsets.back() == this->columns.size() &&
+                 this->columns.size() == this->values.size();
+    for (size_t i = 0; valid && i < rows; ++i) {
+      const size_t begin = this->offsets[i];
+      const size_t end = this->offsets[i + 1];
+      valid = begin <= end && end <= this->columns.size();
+      for (size_t p = begin; valid && p < end; ++p) {
+        valid = this->columns[p] < cols &&
+                (p == begin || this->columns[p - 1] < this->columns[p]);
+      }
+    }
+    if (!valid) {
+      throw std::invalid_argument("Invalid sparse matrix structure");
+    }
+  }
+
+  /**
+   * @brief Convert a dense matrix, storing its non-zero elements.
+   *
+   * @param dense Matrix to convert.
+   * @return SparseMatrix<T> The sparse matrix.
+   */
+  static auto fromDense(const Matrix<T> &dense) -> SparseMatrix<T> {
+    SparseMatrix<T> result(dense.getRows(), dense.getCols());
+    const size_t n = dense.getCols();
+    forRowBlocks(result.rows, dense.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const T *row = dense.rowPtr(i);
+        result.offsets[i + 1] = static_cast<size_t>(
+            std::count_if(row, row + n, [](T x) { return x != T(); }));
+      }
+    });
+    result.accumulateOffsets();
+    forRowBlocks(result.rows, dense.size(), [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const T *row = dense.rowPtr(i);
+        size_t out = result.offsets[i];
+        for (size_t j = 0; j < n; ++j) {
+          if (row[j] != T()) {
+            result.columns[out] = j;
+            result.values[out++] = row[j];
+          }
+        }
+      }
+    });
+    return result;
+  }
+
+  /**
+   * @brief Convert to a dense matrix.
+   *
+   * @return Matrix<T> The dense matrix.
+   */
+  [[nodiscard]] auto toDense() const -> Matrix<T> {
+    Matrix<T> result(rows, cols);
+    T *out = result.raw();
+    forRowBlocks(rows, rows * cols, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        T *row = out + i * cols;
+        for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+          row[columns[p]] = values[p];
+        }
+      }
+    });
+    return result;
+  }
+
+  /**
+   * @brief The transpose, in CSR form.
+   *
+   * The CSR arrays of the transpose are the CSC arrays of this matrix.
+   *
+   * @return SparseMatrix<T> The transpose.
+   */
+  [[nodiscard]] auto transpose() const -> SparseMatrix<T> {
+    SparseMatrix<T> result(cols, rows);
+    for (size_t col : columns) {
+      ++result.offsets[col + 1];
+    }
+    result.accumulateOffsets();
+    std::vector<size_t> next(result.offsets.begin(), result.offsets.end() - 1);
+    for (size_t i = 0; i < rows; ++i) {
+      for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+        const size_t out = next[columns[p]]++;
+        result.columns[out] = i;
+        result.values[out] = values[p];
+      }
+    }
+    return result;
+  }
+
+  /**
+   * @brief Element at the specified position, zero if not stored.
+   *
+   * @param row Row index.
+   * @param col Column index.
+   * @return T The element.
+   */
+  auto operator()(size_t row, size_t col) const -> T {
+    const auto first = columns.begin() + static_cast<ptrdiff_t>(offsets[row]);
+    const auto last =
+        columns.begin() + static_cast<ptrdiff_t>(offsets[row + 1]);
+    const auto it = std::lower_bound(first, last, col);
+    return it != last && *it == col ? values[it - columns.begin()] : T();
+  }
+
+  [[nodiscard]] auto getRows() const -> size_t { return rows; }
+  [[nodiscard]] auto getCols() const -> size_t { return cols; }
+  [[nodiscard]] auto size() const -> size_t { return rows * cols; }
+
+  /**
+   * @brief Number of stored entries.
+   *
+   * @return size_t Stored entries.
+   */
+  [[nodiscard]] auto nonZeros() const -> size_t { return values.size(); }
+
+  /**
+   * @brief Bytes used by the CSR arrays.
+   *
+   * @return size_t Storage size.
+   */
+  [[nodiscard]] auto storageBytes() const -> size_t {
+    return offsets.size() * sizeof(size_t) +
+           values.size() * (sizeof(size_t) + sizeof(T));
+  }
+
+  [[nodiscard]] auto rowOffsets() const -> const std::vector<size_t> & {
+    return offsets;
+  }
+
+  [[nodiscard]] auto columnIndices() const -> const std::vector<size_t> & {
+    return columns;
+  }
+
+  [[nodiscard]] auto getValues() const -> const std::vector<T> & {
+    return values;
+  }
+
+  auto operator+(const SparseMatrix<T> &other) const -> SparseMatrix<T> {
+    return combine(other, T(1));
+  }
+
+  auto operator-(const SparseMatrix<T> &other) const -> SparseMatrix<T> {
+    return combine(other, T(-1));
+  }
+
+  auto operator*(T scalar) const -> SparseMatrix<T> {
+    SparseMatrix<T> result = *this;
+    for (T &value : result.values) {
+      value *= scalar;
+    }
+    return result;
+  }
+
+  /**
+   * @brief Sparse times dense product, parallel over rows of the result.
+   *
+   * @param dense Right operand.
+   * @return Matrix<T> The dense product.
+   * @throws std::invalid_argument if the inner dimensions differ.
+   */
+  auto operator*(const Matrix<T> &dense) const -> Matrix<T> {
+    if (cols != dense.getRows()) {
+      throw std::invalid_argument(
+          "Matrix dimensions must match for multiplication");
+    }
+    const size_t n = dense.getCols();
+    Matrix<T> result(rows, n);
+    T *raw = result.raw();
+    forRowBlocks(rows, nonZeros() * n, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        T *out = raw + i * n;
+        for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+          const T a = values[p];
+          const T *b = dense.rowPtr(columns[p]);
+          for (size_t j = 0; j < n; ++j) {
+            out[j] += a * b[j];
+          }
+        }
+      }
+    });
+    return result;
+  }
+
+  /**
+   * @brief Sparse times sparse product (Gustavson's row-by-row algorithm).
+   *
+   * A symbolic pass counts each row of the result, then a numeric pass
+   * accumulates it in a dense row buffer private to each block of rows.
+   *
+   * @param other Right operand.
+   * @return SparseMatrix<T> The sparse product.
+   * @throws std::invalid_argument if the inner dimensions differ.
+   */
+  auto operator*(const SparseMatrix<T> &other) const -> SparseMatrix<T> {
+    if (cols != other.rows) {
+      throw std::invalid_argument(
+          "Matrix dimensions must match for multiplication");
+    }
+    const size_t n = other.cols;
+    SparseMatrix<T> result(rows, n);
+    size_t work = 0;
+    for (size_t col : columns) {
+      work += other.offsets[col + 1] - other.offsets[col];
+    }
+
+    forRowBlocks(rows, work, [&](size_t begin, size_t end) {
+      std::vector<size_t> marker(n, SIZE_MAX);
+      for (size_t i = begin; i < end; ++i) {
+        size_t count = 0;
+        for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+          const size_t k = columns[p];
+          for (size_t q = other.offsets[k]; q < other.offsets[k + 1]; ++q) {
+            if (marker[other.columns[q]] != i) {
+              marker[other.columns[q]] = i;
+              ++count;
+            }
+          }
+        }
+        result.offsets[i + 1] = count;
+      }
+    });
+    result.accumulateOffsets();
+
+    forRowBlocks(rows, work, [&](size_t begin, size_t end) {
+      std::vector<size_t> marker(n, SIZE_MAX);
+      std::vector<T> accumulator(n);
+      for (size_t i = begin; i < end; ++i) {
+        const auto first =
+            result.columns.begin() + static_cast<ptrdiff_t>(result.offsets[i]);
+        auto last = first;
+        for (size_t p = offsets[i]; p < offsets[i + 1]; ++p) {
+          const size_t k = columns[p];
+          const T a = values[p];
+          for (size_t q = other.offsets[k]; q < other.offsets[k + 1]; ++q) {
+            const size_t j = other.columns[q];
+            if (marker[j] != i) {
+              marker[j] = i;
+              accumulator[j] = T();
+              *last++ = j;
+            }
+            accumulator[j] += a * other.values[q];
+          }
+        }
+        std::sort(first, last);
+        for (size_t p = result.offsets[i]; p < result.offsets[i + 1]; ++p) {
+          result.values[p] = accumulator[result.columns[p]];
+        }
+      }
+    });
+    return result;
+  }
+
+  /**
+   * @brief Dense times sparse product, parallel over rows of the result.
+   *
+   * Row i of the product is the sum of the sparse rows weighted by row i of
+   * the dense operand.
+   *
+   * @param dense Left operand.
+   * @param sparse Right operand.
+   * @return Matrix<T> The dense product.
+   * @throws std::invalid_argument if the inner dimensions differ.
+   */
+  friend auto operator*(const Matrix<T> &dense, const SparseMatrix<T> &sparse)
+      -> Matrix<T> {
+    if (dense.getCols() != sparse.rows) {
+      throw std::invalid_argument(
+          "Matrix dimensions must match for multiplication");
+    }
+    const size_t n = sparse.cols;
+    Matrix<T> result(dense.getRows(), n);
+    T *raw = result.raw();
+    const size_t work = dense.getRows() * sparse.nonZeros();
+    forRowBlocks(dense.getRows(), work, [&](size_t begin, size_t end) {
+      for (size_t i = begin; i < end; ++i) {
+        const T *a = dense.rowPtr(i);
+        T *out = raw + i * n;
+        for (size_t k = 0; k < sparse.rows; ++k) {
+          if (a[k] == T()) {
+            continue;
+          }
+          for (size_t p = sparse.offsets[k]; p < sparse.offsets[k + 1]; ++p) {
+            out[sparse.columns[p]] += a[k] * sparse.values[p];
+          }
+        }
+      }
+    });
+    return result;
+  }
+
+  /**
+   * @brief Print the stored entries, one "(row, col) value" per line.
+   */
+  friend auto operator<<(std::ostream &os, const SparseMatrix<T> &matrix)
+      -> std::ostream & {
+    os << matrix.rows << 'x' << matrix.cols << " sparse, "
+       << matrix.nonZeros() << " stored\n";
+    for (size_t i = 0; i < matrix.rows; ++i) {
+      for (size_t p = matrix.offsets[i]; p < matrix.offsets[i + 1]; ++p) {
+        os << "  (" << i << ", " << matrix.columns[p] << ")" << std::setw(8)
+           << matrix.values[p] << '\n';
+      }
+    }
+    return os;
+  }
+};
+
+#endif // SPARSE_MATRIX_H
@@ -0,0 +1,198 @@
+#ifndef STRASSEN_H
+#define STRASSEN_H
+
+#include "Gemm.h"
+#include "Simd.h"
+#include <algorithm>
+#include <cstddef>
+
+/**
+ * @brief Strassen-Winograd multiplication of large square matrices.
+ *
+ * Each level splits C = A * B into 2 x 2 blocks and forms the product from 7
+ * half-size products and 15 block additions instead of 8 products, using
+ * the Winograd variant's schedule with two temporaries per level (Boyer,
+ * Dumas, Pernet and Zhou, 2009). Blocks of STRASSEN_CROSSOVER or fewer rows
+ * are multiplied by the blocked kernel.
+ *
+ * Error bound: the result is not accurate componentwise, only normwise. With
+ * unit roundoff u (1.1e-16 for double) and recursion down to blocks of order
+ * n0, Higham (Accuracy and Stability of Numerical Algorithms, 2nd ed.,
+ * section 23.2.3) gives, to first order,
+ *
+ *   max|C - fl(C)| <= [(n/n0)^log2(18) * (n0^2 + 6 n0) - 6n] u max|A| max|B|
+ *
+ * In the same norm the conventional product is bounded by n^2 u max|A| max|B|,
+ * which grows 4-fold when n doubles against 18-fold per Winograd level: each
+ * level costs about two bits, so 8192 x 8192 with four levels may lose about
+ * three more decimal digits. Small entries of C are affected the most, since
+ * the error scales with the largest entries of A and B; only enable it where
+ * that precision is acceptable.
+ */
+namespace gemm {
+
+/**
+ * @brief Largest block multiplied directly by the blocked kernel.
+ *
+ * Below roughly this size the 15 additions per level cost more than the
+ * eighth product they save.
+ */
+constexpr size_t STRASSEN_CROSSOVER = 512;
+
+namespace detail {
+
+/**
+ * @brief c = a op b on n x n blocks with leading dimensions.
+ */
+template <typename T>
+void combine(simd::Op op, size_t n, const T *a, size_t lda, const T *b,
+             size_t ldb, T *c, size_t ldc) {
+  for (size_t i = 0; i < n; ++i) {
+    simd::binary(op, a + i * lda, b + i * ldb, c + i * ldc, n,
+                 simd::Store::CACHED);
+  }
+}
+
+/**
+ * @brief Recursive C = A * B for n x n blocks, n divisible by 2^levels.
+ *
+ * @param work Scratch of 2 (n/2)^2 elements per remaining level.
+ */
+template <typename T>
+void winograd(size_t levels, size_t n, const T *a, size_t lda, const T *b,
+              size_t ldb, T *c, size_t ldc, T *work) {
+  if (levels == 0) {
+    blocked(n, n, n, a, lda, b, ldb, c, ldc);
+    return;
+  }
+
+  constexpr simd::Op ADD = simd::Op::ADD;
+  constexpr simd::Op SUB = simd::Op::SUB;
+  const size_t h = n / 2;
+  const T *a11 = a;
+  const T *a12 = a + h;
+  const T *a21 = a + h * lda;
+  const T *a22 = a21 + h;
+  const T *b11 = b;
+  const T *b12 = b + h;
+  const T *b21 = b + h * ldb;
+  const T *b22 = b21 + h;
+  T *c11 = c;
+  T *c12 = c + h;
+  T *c21 = c + h * ldc;
+  T *c22 = c21 + h;
+  T *x = work;
+  T *y = x + h * h;
+  T *next = y + h * h;
+  auto product = [&](const T *l, size_t ldl, const T *r, size_t ldr, T *out,
+                     size_t ldo) {
+    winograd(levels - 1, h, l, ldl, r, ldr, out, ldo, next);
+  };
+
+  // P7 = (A11 - A21)(B22 - B12) in C21
+  combine(SUB, h, a11, lda, a21, lda, x, h);
+  combine(SUB, h, b22, ldb, b12, ldb, y, h);
+  product(x, h, y, h, c21, ldc);
+  // P5 = S1 T1 in C22, with S1 = A21 + A22 and T1 = B12 - B11
+  combine(ADD, h, a21, lda, a22, lda, x, h);
+  combine(SUB, h, b12, ldb, b11, ldb, y, h);
+  product(x, h, y, h, c22, ldc);
+  // P6 = S2 T2 in C12, with S2 = S1 - A11 and T2 = B22 - T1
+  combine(SUB, h, x, h, a11, lda, x, h);
+  combine(SUB, h, b22, ldb, y, h, y, h);
+  product(x, h, y, h, c12, ldc);
+  // P3 = (A12 - S2) B22 in C11
+  combine(SUB, h, a12, lda, x, h, x, h);
+  product(x, h, b22, ldb, c11, ldc);
+  // P1 = A11 B11 in X
+  product(a11, lda, b11, ldb, x, h);
+  // U2 = P1 + P6, U3 = U2 + P7 (C21), U4 = U2 + P5, U7 = U3 + P5 (C22),
+  // U5 = U4 + P3 (C12)
+  combine(ADD, h, x, h, c12, ldc, c12, ldc);
+  combine(ADD, h, c12, ldc, c21, ldc, c21, ldc);
+  combine(ADD, h, c12, ldc, c22, ldc, c12, ldc);
+  combine(ADD, h, c21, ldc, c22, ldc, c22, ldc);
+  combine(ADD, h, c12, ldc, c11, ldc, c12, ldc);
+  // P4 = A22 (T2 - B21) in C11, U6 = U3 - P4 (C21)
+  combine(SUB, h, y, h, b21, ldb, y, h);
+  product(a22, lda, y, h, c11, ldc);
+  combine(SUB, h, c21, ldc, c11, ldc, c21, ldc);
+  // P2 = A12 B21 in C11, U1 = P1 + P2 (C11)
+  product(a12, lda, b21, ldb, c11, ldc);
+  combine(ADD, h, x, h, c11, ldc, c11, ldc);
+}
+
+/**
+ * @brief Copy an n x n block into the top-left of a zeroed padded x padded
+ * block.
+ */
+template <typename T>
+void pad(size_t n, const T *src, size_t lds, size_t padded, T *dst) {
+  for (size_t i = 0; i < n; ++i) {
+    std::copy_n(src + i * lds, n, dst + i * padded);
+    std::fill(dst + i * padded + n, dst + (i + 1) * padded, T(0));
+  }
+  std::fill(dst + n * padded, dst + padded * padded, T(0));
+}
+
+} // namespace detail
+
+/**
+ * @brief Strassen-Winograd C = A * B for n x n matrices, overwriting C.
+ *
+ * The number of levels is the smallest that brings the blocks down to
+ * STRASSEN_CROSSOVER rows; when n is not a multiple of 2^levels, A and B are
+ * zero-padded once to the next multiple. All scratch, about 2/3 n^2 elements
+ * plus 3 n^2 when padding, is allocated up front in a single buffer. Below
+ * the crossover this is the blocked kernel.
+ *
+ * @param n Order of the matrices.
+ * @param a Pointer to A.
+ * @param lda Leading dimension of A.
+ * @param b Pointer to B.
+ * @param ldb Leading dimension of B.
+ * @param c Pointer to C.
+ * @param ldc Leading dimension of C.
+ */
+template <typename T>
+void strassen(size_t n, const T *a, size_t lda, const T *b, size_t ldb, T *c,
+              size_t ldc) {
+  size_t levels = 0;
+  size_t base = n;
+  while (base > STRASSEN_CROSSOVER) {
+    base = (base + 1) / 2;
+    ++levels;
+  }
+  if (levels == 0) {
+    blocked(n, n, n, a, lda, b, ldb, c, ldc);
+    return;
+  }
+
+  const size_t padded = base << levels;
+  size_t scratch = 0;
+  for (size_t l = 1; l <= levels; ++l) {
+    scratch += 2 * (padded >> l) * (padded >> l);
+  }
+  if (padded == n) {
+    Buffer<T> workspace(scratch);
+    detail::winograd(levels, n, a, lda, b, ldb, c, ldc, workspace.data());
+    return;
+  }
+
+  const size_t square = padded * padded;
+  Buffer<T> workspace(scratch + 3 * square);
+  T *pa = workspace.data() + scratch;
+  T *pb = pa + square;
+  T *pc = pb + square;
+  detail::pad(n, a, lda, padded, pa);
+  detail::pad(n, b, ldb, padded, pb);
+  detail::winograd(levels, padded, pa, padded, pb, padded, pc, padded,
+                   workspace.data());
+  for (size_t i = 0; i < n; ++i) {
+    std::copy_n(pc + i * padded, n, c + i * ldc);
+  }
+}
+
+} // namespace gemm
+
+#endif // STRASSEN_H
@@ -0,0 +1,306 @@
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Process-wide work-stealing thread pool.
+ *
+ * Every worker owns a deque: it pops its own tasks from the back and steals
+ * from the front of the other workers' deques when it runs dry. Tasks pushed
+ * from outside the pool are distributed round-robin. A worker that blocks in
+ * parallelFor() keeps executing queued tasks, so nested parallel regions do
+ * not deadlock, and sleeps while there are none.
+ *
+ * The shared instance is sized from the NL_NUM_THREADS environment variable,
+ * falling back to the number of hardware threads.
+ */
+class ThreadPool {
+public:
+  using Task = std::function<void()>;
+
+  /**
+   * @brief Constructor.
+   *
+   * @param threads Number of worker threads (at least one is started).
+   */
+  explicit ThreadPool(size_t threads) { start(std::max<size_t>(threads, 1)); }
+
+  ThreadPool(const ThreadPool &) = delete;
+  auto operator=(const ThreadPool &) -> ThreadPool & = delete;
+
+  ~ThreadPool() { stop(); }
+
+  /**
+   * @brief The pool shared by all kernels in the process.
+   *
+   * @return ThreadPool& The shared pool.
+   */
+  static auto instance() -> ThreadPool & {
+    static ThreadPool pool(defaultThreadCount());
+    return pool;
+  }
+
+  /**
+   * @brief Thread count taken from NL_NUM_THREADS or the hardware.
+   *
+   * @return size_t Number of threads to use by default.
+   */
+  static auto defaultThreadCount() -> size_t {
+    if (const char *env = std::getenv("NL_NUM_THREADS")) {
+      const long value = std::strtol(env, nullptr, 10);
+      if (value > 0) {
+        return static_cast<size_t>(value);
+      }
+    }
+    return std::max<unsigned>(std::thread::hardware_concurrency(), 1U);
+  }
+
+  /**
+   * @brief Get the number of worker threads.
+   *
+   * @return size_t Number of workers.
+   */
+  [[nodiscard]] auto threadCount() const -> size_t { return workers.size(); }
+
+  /**
+   * @brief Restart the pool with a different number of workers.
+   *
+   * Queued tasks are drained first. Must not be called from a worker or
+   * while a parallelFor() is in flight.
+   *
+   * @param threads New number of worker threads (at least one).
+   */
+  void setThreadCount(size_t threads) {
+    threads = std::max<size_t>(threads, 1);
+    if (threads == workers.size()) {
+      return;
+    }
+    stop();
+    start(threads);
+  }
+
+  /**
+   * @brief Queue a task for asynchronous execution.
+   *
+   * @param task Task to run on one of the workers.
+   */
+  void submit(Task task) {
+    const int self = workerIndex();
+    const size_t target = self >= 0 ? static_cast<size_t>(self)
+                                    : nextQueue++ % queues.size();
+    // Count the task before publishing it, so that tryRun() never takes
+    // pending below zero.
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      ++pending;
+    }
+    {
+      std::lock_guard<std::mutex> lock(queues[target]->mutex);
+      queues[target]->tasks.push_back(std::move(task));
+    }
+    wake.notify_one();
+  }
+
+  /**
+   * @brief Run fn(i) for every i in [0, count) and wait for completion.
+   *
+   * Indices are handed out dynamically to at most threadCount() runners.
+   * With a single worker, or a single index, the loop runs inline. The first
+   * exception thrown by fn is rethrown in the caller.
+   *
+   * @param count Number of iterations.
+   * @param fn Callable taking the iteration index.
+   */
+  template <typename F> void parallelFor(size_t count, F &&fn) {
+    const size_t runners = std::min(count, threadCount());
+    if (runners <= 1) {
+      for (size_t i = 0; i < count; ++i) {
+        fn(i);
+      }
+      return;
+    }
+
+    struct State {
+      std::atomic<size_t> next{0};
+      std::atomic<size_t> remaining{0};
+      std::mutex mutex;
+      std::condition_variable done;
+      std::exception_ptr error;
+    };
+    auto state = std::make_shared<State>();
+    state->remaining = runners;
+
+    auto body = [this, state, &fn, count]() {
+      try {
+        for (size_t i = state->next++; i < count; i = state->next++) {
+          fn(i);
+        }
+      } catch (...) {
+        std::lock_guard<std::mutex> lock(state->mutex);
+        if (!state->error) {
+          state->error = std::current_exception();
+        }
+        state->next = count;
+      }
+      if (--state->remaining == 0) {
+        {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          state->done.notify_all();
+        }
+        // A worker waiting in parallelFor() sleeps on the pool's condition.
+        { std::lock_guard<std::mutex> lock(sleepMutex); }
+        wake.notify_all();
+      }
+    };
+    for (size_t r = 0; r < runners; ++r) {
+      submit(body);
+    }
+
+    const int self = workerIndex();
+    if (self >= 0) {
+      // Help with queued tasks; with nothing to steal, sleep until a task is
+      // queued or the last runner finishes.
+      auto idle = [this, &state]() {
+        return state->remaining == 0 || pending > 0;
+      };
+      while (state->remaining > 0) {
+        if (!tryRun(static_cast<size_t>(self))) {
+          std::unique_lock<std::mutex> lock(sleepMutex);
+          wake.wait_for(lock, IDLE_RECHECK, idle);
+        }
+      }
+    } else {
+      auto finished = [&state]() { return state->remaining == 0; };
+      std::unique_lock<std::mutex> lock(state->mutex);
+      while (!state->done.wait_for(lock, IDLE_RECHECK, finished)) {
+      }
+    }
+
+    if (state->error) {
+      std::rethrow_exception(state->error);
+    }
+  }
+
+private:
+  /**
+   * @brief Upper bound on how long a sleeping thread goes without rechecking.
+   */
+  static constexpr std::chrono::milliseconds IDLE_RECHECK{100};
+
+  struct Queue {
+    std::mutex mutex;
+    std::deque<Task> tasks;
+  };
+
+  std::vector<std::unique_ptr<Queue>> queues;
+  std::vector<std::thread> workers;
+  std::mutex sleepMutex;
+  std::condition_variable wake;
+  size_t pending = 0;
+  bool stopping = false;
+  std::atomic<size_t> nextQueue{0};
+
+  struct WorkerIdentity {
+    const ThreadPool *pool = nullptr;
+    int index = -1;
+  };
+
+  static auto identity() -> WorkerIdentity & {
+    thread_local WorkerIdentity current;
+    return current;
+  }
+
+  /**
+   * @brief Index of the calling thread in this pool, or -1 for outsiders.
+   */
+  [[nodiscard]] auto workerIndex() const -> int {
+    const WorkerIdentity &id = identity();
+    return id.pool == this ? id.index : -1;
+  }
+
+  void start(size_t threads) {
+    stopping = false;
+    queues.clear();
+    for (size_t i = 0; i < threads; ++i) {
+      queues.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+      workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+  }
+
+  void stop() {
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      stopping = true;
+    }
+    wake.notify_all();
+    for (auto &worker : workers) {
+      worker.join();
+    }
+    workers.clear();
+  }
+
+  /**
+   * @brief Pop one task from the own deque or steal one, and run it.
+   *
+   * @return bool Whether a task was executed.
+   */
+  auto tryRun(size_t self) -> bool {
+    Task task;
+    {
+      Queue &own = *queues[self];
+      std::lock_guard<std::mutex> lock(own.mutex);
+      if (!own.tasks.empty()) {
+        task = std::move(own.tasks.back());
+        own.tasks.pop_back();
+      }
+    }
+    for (size_t offset = 1; !task && offset < queues.size(); ++offset) {
+      Queue &victim = *queues[(self + offset) % queues.size()];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tasks.empty()) {
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+      }
+    }
+    if (!task) {
+      return false;
+    }
+    {
+      std::lock_guard<std::mutex> lock(sleepMutex);
+      --pending;
+    }
+    task();
+    return true;
+  }
+
+  void workerLoop(size_t self) {
+    identity() = {this, static_cast<int>(self)};
+    while (true) {
+      if (tryRun(self)) {
+        continue;
+      }
+      std::unique_lock<std::mutex> lock(sleepMutex);
+      wake.wait_for(lock, IDLE_RECHECK,
+                    [this]() { return stopping || pending > 0; });
+      if (stopping && pending == 0) {
+        return;
+      }
+    }
+  }
+};
+
+#endif // THREAD_POOL_H
@@ -1,34 +1,46 @@
 #ifndef TOKEN_H
 #define TOKEN_H
 
-#include "Matrix.h"
-#include <memory>
-#include <string>
-#include <variant>
+#include <cstddef>
+#include <string_view>
 
 enum class TokenType {
-  NUMBER,     // Numeric literal
-  IDENTIFIER, // Variable names
-  PLUS,       // +
-  MINUS,      // -
-  MULTIPLY,   // *
-  ASSIGN,     // =
-  SEMICOLON,  // ;
-  LPAREN,     // (
-  RPAREN,     // )
-  LBRACKET,   // [
-  RBRACKET,   // ]
-  COMMA,      // ,
-  EOL,        // End of line
-  END         // End of input
+  NUMBER,          // Numeric literal
+  IDENTIFIER,      // Variable names
+  STRING,          // "text"
+  PLUS,            // +
+  MINUS,           // -
+  MULTIPLY,        // *
+  ASSIGN,          // =
+  PLUS_ASSIGN,     // +=
+  MINUS_ASSIGN,    // -=
+  MULTIPLY_ASSIGN, // *=
+  SEMICOLON,       // ;
+  LPAREN,          // (
+  RPAREN,          // )
+  LBRACKET,        // [
+  RBRACKET,        // ]
+  COMMA,           // ,
+  EOL,             // End of line
+  ERROR,           // Unexpected character
+  END              // End of input
 };
 
+/**
+ * @brief A lexical token.
+ *
+ * The lexeme is a view into the source text, which must outlive the token.
+ * Numeric literals also carry their parsed value.
+ */
 struct Token {
   TokenType type;
-  std::string lexeme;
+  std::string_view lexeme;
+  double number = 0.0;
+  size_t line = 1;
 
-  Token(TokenType type, std::string lexeme)
-      : type(type), lexeme(std::move(lexeme)) {}
+  Token(TokenType type, std::string_view lexeme, double number = 0.0,
+        size_t line = 1)
+      : type(type), lexeme(lexeme), number(number), line(line) {}
 };
 
 #endif // TOKEN_H
\ No newline at end of file
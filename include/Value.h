@@ -0,0 +1,250 @@
+#ifndef VALUE_H
+#define VALUE_H
+
+#include "Gemm.h"
+#include "Matrix.h"
+#include "SparseMatrix.h"
+#include <cstdint>
+#include <iostream>
+#include <variant>
+
+/**
+ * @brief Element type of a value.
+ */
+enum class DType : uint8_t {
+  INT32,   // int32_t dense matrices
+  FLOAT32, // float dense matrices
+  FLOAT64  // double: scalars, dense and sparse matrices
+};
+
+/**
+ * @brief Element type of the result of combining two matrices.
+ *
+ * Equal types are kept; any other pair is computed in FLOAT64, so int32
+ * with float32 does not lose the integers that float cannot represent.
+ *
+ * @param a Type of the first operand.
+ * @param b Type of the second operand.
+ * @return DType The common type.
+ */
+auto promote(DType a, DType b) -> DType;
+
+/**
+ * @brief Whether a scalar keeps an int32 matrix int32: it must be an
+ * integer within int32_t's range.
+ *
+ * @param s Scalar operand or factor.
+ * @return bool True if s converts to int32_t exactly.
+ */
+auto fitsInt32(double s) -> bool;
+
+/**
+ * @brief A value of the language: a scalar, a dense or a sparse matrix.
+ *
+ * Operations dispatch on the representations of their operands. Scalars are
+ * kept unboxed, so scalar arithmetic never allocates; a scalar behaves as a
+ * 1x1 matrix and, like any 1x1 operand, is broadcast against a matrix.
+ *
+ * Dense matrices are float64, float32 or int32 (see DType). Operations on
+ * matrices of the same type run in that type; mixed types follow promote().
+ * A scalar takes the type of the matrix it meets, except that a scalar
+ * meeting an int32 matrix gives a float64 result unless fitsInt32(). Int32
+ * sums, differences and products wrap around on overflow, as in NumPy.
+ *
+ * A Value converts implicitly to a dense float64 Matrix, converting other
+ * representations, so code that only deals with Matrix<double> can keep
+ * using it.
+ */
+class Value {
+private:
+  std::variant<Matrix<double>, SparseMatrix<double>, double, Matrix<float>,
+               Matrix<int32_t>>
+      data;
+
+public:
+  Value() = default;
+  Value(Matrix<double> matrix) : data(std::move(matrix)) {}
+  Value(SparseMatrix<double> matrix) : data(std::move(matrix)) {}
+  Value(double scalar) : data(scalar) {}
+  Value(Matrix<float> matrix) : data(std::move(matrix)) {}
+  Value(Matrix<int32_t> matrix) : data(std::move(matrix)) {}
+
+  /**
+   * @brief Wrap the result of a sparse operation, densifying it when the
+   * dense form takes no more memory than the sparse one.
+   *
+   * @param matrix Sparse result.
+   * @return Value The value in the cheaper representation.
+   */
+  static auto compact(SparseMatrix<double> matrix) -> Value;
+
+  /**
+   * @brief Whether the value is held as a T, e.g. Matrix<float>.
+   */
+  template <typename T> [[nodiscard]] auto holds() const -> bool {
+    return std::holds_alternative<T>(data);
+  }
+
+  /**
+   * @brief The value held as a T; see holds().
+   *
+   * @return T& The representation.
+   */
+  template <typename T> auto get() -> T & { return std::get<T>(data); }
+
+  template <typename T> [[nodiscard]] auto get() const -> const T & {
+    return std::get<T>(data);
+  }
+
+  [[nodiscard]] auto isDense() const -> bool {
+    return std::holds_alternative<Matrix<double>>(data);
+  }
+
+  [[nodiscard]] auto isSparse() const -> bool {
+    return std::holds_alternative<SparseMatrix<double>>(data);
+  }
+
+  [[nodiscard]] auto isScalar() const -> bool {
+    return std::holds_alternative<double>(data);
+  }
+
+  [[nodiscard]] auto dtype() const -> DType;
+
+  /**
+   * @brief The dense float64 matrix of a dense float64 value.
+   *
+   * @return Matrix<double>& The matrix.
+   */
+  auto dense() -> Matrix<double> & { return std::get<Matrix<double>>(data); }
+
+  [[nodiscard]] auto dense() const -> const Matrix<double> & {
+    return std::get<Matrix<double>>(data);
+  }
+
+  /**
+   * @brief The sparse matrix of a sparse value.
+   *
+   * @return const SparseMatrix<double>& The matrix.
+   */
+  [[nodiscard]] auto sparse() const -> const SparseMatrix<double> & {
+    return std::get<SparseMatrix<double>>(data);
+  }
+
+  /**
+   * @brief The number held by a scalar value.
+   *
+   * @return const double& The scalar.
+   */
+  [[nodiscard]] auto scalar() const -> const double & {
+    return std::get<double>(data);
+  }
+
+  /**
+   * @brief The value as a dense matrix, converting it if sparse.
+   *
+   * @return Matrix<double> The dense matrix, sharing the buffer if the value
+   * is already dense, or a 1x1 matrix for a scalar.
+   */
+  [[nodiscard]] auto toDense() const -> Matrix<double> {
+    return as<double>();
+  }
+
+  /**
+   * @brief The value as a dense matrix of element type T, converting it if
+   * needed.
+   *
+   * @tparam T double, float or int32_t.
+   * @return Matrix<T> The dense matrix, sharing the buffer if the value is
+   * already a dense Matrix<T>.
+   */
+  template <typename T> [[nodiscard]] auto as() const -> Matrix<T>;
+
+  /**
+   * @brief The value converted to another element type.
+   *
+   * Converting to FLOAT64 keeps scalars and sparse matrices as they are;
+   * other conversions give a dense matrix, including for scalars.
+   *
+   * @param type Element type of the result.
+   * @return Value The converted value.
+   */
+  [[nodiscard]] auto convert(DType type) const -> Value;
+
+  operator Matrix<double>() const { return toDense(); }
+
+  [[nodiscard]] auto getRows() const -> size_t;
+  [[nodiscard]] auto getCols() const -> size_t;
+  [[nodiscard]] auto size() const -> size_t { return getRows() * getCols(); }
+
+  /**
+   * @brief Element at the specified position.
+   *
+   * @param row Row index.
+   * @param col Column index.
+   * @return double The element.
+   */
+  auto operator()(size_t row, size_t col) const -> double;
+
+  friend auto operator<<(std::ostream &os, const Value &value)
+      -> std::ostream &;
+};
+
+template <typename T> auto Value::as() const -> Matrix<T> {
+  return std::visit(
+      [](const auto &value) -> Matrix<T> {
+        using V = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<V, double>) {
+          return Matrix<double>(1, 1, &value).template cast<T>();
+        } else if constexpr (std::is_same_v<V, SparseMatrix<double>>) {
+          return value.toDense().template cast<T>();
+        } else {
+          return value.template cast<T>();
+        }
+      },
+      data);
+}
+
+/**
+ * @brief Matrix product of two values.
+ *
+ * A 1x1 operand scales the other, as in Matrix::operator*, and the product
+ * of two scalars is a scalar. Dense products run in the promoted type of
+ * the operands. Sparse times sparse stays sparse unless the result fills
+ * in; a product of a sparse and a dense operand is dense float64.
+ *
+ * @param a Left operand.
+ * @param b Right operand.
+ * @param algorithm Algorithm for large dense square products.
+ * @return Value The product.
+ * @throws std::invalid_argument if the inner dimensions differ.
+ */
+auto multiply(const Value &a, const Value &b, gemm::Algorithm algorithm)
+    -> Value;
+
+/**
+ * @brief Element-wise sum or difference of two values.
+ *
+ * Two scalars give a scalar and a 1x1 operand is broadcast against the
+ * other. Two sparse operands give a sparse result unless it fills in;
+ * otherwise both are added as dense matrices of their promoted type.
+ *
+ * @param a Left operand.
+ * @param b Right operand.
+ * @param subtract Compute a - b instead of a + b.
+ * @return Value The result.
+ * @throws std::invalid_argument if the shapes differ and neither is 1x1.
+ */
+auto add(const Value &a, const Value &b, bool subtract) -> Value;
+
+/**
+ * @brief Multiply every element by a scalar, keeping the representation.
+ *
+ * An int32 matrix scaled by a factor that is not an int32 becomes float64.
+ *
+ * @param a Operand.
+ * @param factor Scalar factor.
+ * @return Value The result.
+ */
+auto scale(const Value &a, double factor) -> Value;
+
+#endif // VALUE_H
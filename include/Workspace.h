@@ -0,0 +1,69 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include "MappedFile.h"
+#include "Value.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * @brief Header of a workspace snapshot.
+ *
+ * A snapshot is this 64-byte header, the variables as matrix file records
+ * (see MatrixFileHeader) at offsets that are multiples of MATRIX_ALIGNMENT,
+ * and an index at indexOffset. Each index entry is a uint64_t record offset,
+ * a uint32_t name length and the name's bytes, without padding.
+ */
+struct WorkspaceHeader {
+  char magic[4];         // "NLWS"
+  uint16_t version;      // WORKSPACE_VERSION
+  uint16_t reserved0;    // Zero
+  uint32_t reserved1;    // Zero
+  uint64_t count;        // Number of variables
+  uint64_t indexOffset;  // Offset of the index
+  uint8_t reserved2[32]; // Zero
+};
+
+static_assert(sizeof(WorkspaceHeader) == 64, "Unexpected header layout");
+
+constexpr uint16_t WORKSPACE_VERSION = 1;
+
+/**
+ * @brief A variable of a mapped snapshot that has not been materialized.
+ */
+struct StoredVariable {
+  std::shared_ptr<MappedFile> file;
+  size_t offset;
+};
+
+/**
+ * @brief Write variables to a snapshot file.
+ *
+ * The snapshot is written to a temporary file next to path and renamed over
+ * it, so a crash never leaves a truncated snapshot and matrices still mapped
+ * from an older snapshot at the same path stay valid. Each variable keeps
+ * its element type, see writeMatrix().
+ *
+ * @param path Path of the snapshot.
+ * @param variables Names and values to store.
+ * @throws std::runtime_error if the file cannot be written.
+ */
+void saveWorkspace(
+    const std::string &path,
+    const std::vector<std::pair<std::string, const Value *>> &variables);
+
+/**
+ * @brief Map a snapshot and read its index, without touching the data.
+ *
+ * @param path Path of the snapshot.
+ * @return std::vector<std::pair<std::string, StoredVariable>> The variables,
+ * to be materialized with mapMatrix() when first used.
+ * @throws std::runtime_error if the file cannot be read or is invalid.
+ */
+auto openWorkspace(const std::string &path)
+    -> std::vector<std::pair<std::string, StoredVariable>>;
+
+#endif // WORKSPACE_H
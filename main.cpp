@@ -1,20 +1,107 @@
 #include "Interpreter.h"
-#include "Lexer.h"
-#include "Parser.h"
+#include "Profiler.h"
+#include "Runner.h"
+#include "Server.h"
+#include "ThreadPool.h"
+#include <csignal>
+#include <fstream>
 #include <iostream>
+#include <sstream>
 #include <string>
 
-auto main() -> int {
-  Interpreter interpreter;
+namespace {
+
+/**
+ * @brief Handle a REPL command starting with ':'.
+ *
+ * @param interpreter Interpreter the command applies to.
+ * @param line The full input line.
+ */
+void runCommand(Interpreter &interpreter, const std::string &line) {
+  std::istringstream args(line.substr(1));
+  std::string command;
+  args >> command;
+
+  if (command == "threads") {
+    size_t count = 0;
+    if (args >> count) {
+      ThreadPool::instance().setThreadCount(count);
+    }
+    std::cout << "threads: " << ThreadPool::instance().threadCount() << '\n';
+    return;
+  }
+  if (command == "matmul") {
+    std::string algorithm;
+    if (args >> algorithm) {
+      if (algorithm == "standard") {
+        interpreter.setMatMulAlgorithm(gemm::Algorithm::STANDARD);
+      } else if (algorithm == "strassen") {
+        interpreter.setMatMulAlgorithm(gemm::Algorithm::STRASSEN);
+      } else {
+        throw std::runtime_error("Usage: :matmul [standard|strassen].");
+      }
+    }
+    const bool strassen =
+        interpreter.getMatMulAlgorithm() == gemm::Algorithm::STRASSEN;
+    std::cout << "matmul: " << (strassen ? "strassen" : "standard") << '\n';
+    return;
+  }
+  if (command == "profile") {
+    Profiler &profiler = Profiler::instance();
+    std::string action;
+    args >> action;
+    if (action == "on" || action == "off") {
+      profiler.setEnabled(action == "on");
+    } else if (action == "report") {
+      profiler.report(std::cout);
+    } else if (action == "reset") {
+      profiler.reset();
+    } else {
+      throw std::runtime_error("Usage: :profile on|off|report|reset.");
+    }
+    return;
+  }
+  throw std::runtime_error("Unknown command ':" + command + "'.");
+}
+
+/**
+ * @brief Run a script file, or stdin for "-", without prompts.
+ *
+ * @param interpreter Interpreter to run the script in.
+ * @param path Script path.
+ * @return int Exit status: 0 if every statement succeeded.
+ */
+auto runScript(Interpreter &interpreter, const std::string &path) -> int {
+  std::ios::sync_with_stdio(false);
+  Runner runner(interpreter, std::cout, std::cerr);
+
+  size_t failures = 0;
+  if (path == "-") {
+    failures = runner.run(std::cin);
+  } else {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+      std::cerr << "Error: Cannot open '" << path << "'.\n";
+      return 1;
+    }
+    failures = runner.run(file);
+  }
+  return failures == 0 ? 0 : 1;
+}
+
+/**
+ * @brief Read-eval-print loop on stdin.
+ *
+ * @param interpreter Interpreter to evaluate the input in.
+ */
+void runRepl(Interpreter &interpreter) {
   std::string line;
 
   std::cout << "Matrix Calculator (type 'exit' to quit)\n";
 
   while (true) {
     std::cout << "> ";
-    std::getline(std::cin, line);
-
-    if (line == "exit") {
+    if (!std::getline(std::cin, line) || line == "exit") {
       break;
     }
     if (line.empty()) {
@@ -22,28 +109,132 @@ auto main() -> int {
     }
 
     try {
-      Lexer lexer(line);
-      auto tokens = lexer.scanTokens();
-
-      Parser parser(tokens);
-      auto expression = parser.parse();
-
-      bool printResult = true;
-      // Don't print if the line ends with semicolon
-      if (!tokens.empty() &&
-          tokens[tokens.size() - 2].type == TokenType::SEMICOLON) {
-        printResult = false;
+      if (line[0] == ':') {
+        runCommand(interpreter, line);
+        continue;
       }
 
-      Matrix<double> result = interpreter.interpret(expression, printResult);
+      auto program = interpreter.compile(line);
+      Value result = interpreter.execute(*program);
 
-      if (printResult) {
+      if (program->printResult) {
+        Profiler::Scope scope(Profiler::Phase::PRINT);
         std::cout << result << '\n';
       }
     } catch (const std::exception &e) {
       std::cerr << "Error: " << e.what() << '\n';
     }
   }
+}
+
+/**
+ * @brief Server stopped by SIGINT and SIGTERM.
+ */
+Server *activeServer = nullptr;
+
+void stopServer(int /*signal*/) {
+  if (activeServer != nullptr) {
+    activeServer->stop();
+  }
+}
 
+/**
+ * @brief Serve sessions on a socket until interrupted.
+ *
+ * @param path Socket path.
+ * @param workspace Snapshot every session starts from, if not empty.
+ * @return int Exit status.
+ */
+auto runServer(const std::string &path, const std::string &workspace) -> int {
+  ServerOptions options;
+  options.workspace = workspace;
+  Server server(path, options);
+  activeServer = &server;
+  std::signal(SIGINT, stopServer);
+  std::signal(SIGTERM, stopServer);
+  server.run();
+  activeServer = nullptr;
   return 0;
 }
+
+} // namespace
+
+auto main(int argc, char *argv[]) -> int {
+  bool batch = false;
+  std::string script = "-";
+  std::string socket;
+  std::string workspace;
+  std::string profile;
+  bool usage = false;
+  for (int i = 1; i < argc; ++i) {
+    const std::string option = argv[i];
+    if (option == "--run" && !batch) {
+      batch = true;
+      if (i + 1 < argc && std::string(argv[i + 1]).rfind("--", 0) != 0) {
+        script = argv[++i];
+      }
+    } else if (option == "--serve" && i + 1 < argc && socket.empty()) {
+      socket = argv[++i];
+    } else if (option == "--workspace" && i + 1 < argc && workspace.empty()) {
+      workspace = argv[++i];
+    } else if (option == "--profile" && i + 1 < argc && profile.empty()) {
+      profile = argv[++i];
+    } else {
+      usage = true;
+    }
+  }
+  // The server runs sessions concurrently, which the profiler cannot record.
+  if (usage || (!socket.empty() && (batch || !profile.empty()))) {
+    std::cerr << "Usage: " << argv[0]
+              << " [--run [file|-] | --serve socket] [--workspace file]"
+                 " [--profile file]\n";
+    return 2;
+  }
+
+  if (!socket.empty()) {
+    try {
+      return runServer(socket, workspace);
+    } catch (const std::exception &e) {
+      std::cerr << "Error: " << e.what() << '\n';
+      return 1;
+    }
+  }
+
+  Profiler::instance().setEnabled(!profile.empty());
+  Interpreter interpreter;
+  try {
+    if (!workspace.empty() && std::ifstream(workspace)) {
+      interpreter.loadWorkspace(workspace);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+
+  int status = 0;
+  if (batch) {
+    status = runScript(interpreter, script);
+  } else {
+    runRepl(interpreter);
+  }
+
+  // A session that only read the snapshot leaves it as it is.
+  try {
+    if (!workspace.empty() && interpreter.isModified()) {
+      interpreter.saveWorkspace(workspace);
+    }
+  } catch (const std::exception &e) {
+    std::cerr << "Error: " << e.what() << '\n';
+    return 1;
+  }
+
+  if (!profile.empty()) {
+    std::ofstream out(profile);
+    Profiler::instance().writeJson(out);
+    if (!out) {
+      std::cerr << "Error: Cannot write '" << profile << "'.\n";
+      return 1;
+    }
+  }
+  return status;
+}
@@ -0,0 +1,281 @@
+#include "Compiler.h"
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+
+/**
+ * @brief Name and properties of a builtin function.
+ */
+struct BuiltinInfo {
+  std::string_view name;
+  Builtin function;
+  bool returnsValue;
+};
+
+constexpr BuiltinInfo BUILTINS[] = {
+    {"load", Builtin::LOAD, true},
+    {"save", Builtin::SAVE, false},
+    {"readcsv", Builtin::READ_CSV, true},
+    {"savews", Builtin::SAVE_WS, false},
+    {"loadws", Builtin::LOAD_WS, false},
+    {"sparse", Builtin::SPARSE, true},
+    {"dense", Builtin::DENSE, true},
+    {"single", Builtin::SINGLE, true},
+    {"double", Builtin::DOUBLE, true},
+    {"int32", Builtin::INT32, true},
+};
+
+auto findBuiltin(std::string_view name) -> const BuiltinInfo & {
+  for (const BuiltinInfo &info : BUILTINS) {
+    if (info.name == name) {
+      return info;
+    }
+  }
+  throw std::runtime_error("Unknown function '" + std::string(name) + "'.");
+}
+
+/**
+ * @brief Whether a statement leaves its value in 'ans': calls to builtins
+ * without a result do not.
+ */
+auto setsAns(const Expression *expr) -> bool {
+  if (expr->kind == ExprKind::CALL) {
+    return findBuiltin(static_cast<const CallExpr *>(expr)->name).returnsValue;
+  }
+  return true;
+}
+
+} // namespace
+
+auto Compiler::compile(const std::shared_ptr<Expression> &expression,
+                       bool printResult) -> std::shared_ptr<const Program> {
+  Compiler compiler;
+  compiler.program.result = compiler.emit(expression.get());
+  compiler.program.printResult = printResult;
+  compiler.program.setsAns = setsAns(expression.get());
+  return std::make_shared<const Program>(std::move(compiler.program));
+}
+
+auto Compiler::emit(const Expression *expr) -> uint32_t {
+  switch (expr->kind) {
+  case ExprKind::LITERAL:
+  case ExprKind::NUMBER: {
+    const uint32_t dst = allocate();
+    program.code.push_back({OpCode::LOAD_CONST, dst, constant(expr), 0});
+    return dst;
+  }
+  case ExprKind::BINARY:
+    if (isElementwise(expr)) {
+      return emitFused(expr, NO_OPERAND);
+    }
+    return emitBinary(static_cast<const BinaryExpr *>(expr));
+  case ExprKind::VARIABLE: {
+    const uint32_t dst = allocate();
+    program.code.push_back(
+        {OpCode::LOAD_VAR, dst,
+         nameSlot(static_cast<const VariableExpr *>(expr)->name), 0});
+    return dst;
+  }
+  case ExprKind::ASSIGN: {
+    const auto *assignExpr = static_cast<const AssignExpr *>(expr);
+    if (isElementwise(assignExpr->value)) {
+      return emitFused(assignExpr->value, nameSlot(assignExpr->name));
+    }
+    const uint32_t value = emit(assignExpr->value);
+    program.code.push_back(
+        {OpCode::STORE_VAR, 0, nameSlot(assignExpr->name), value});
+    return value;
+  }
+  case ExprKind::CALL:
+    return emitCall(static_cast<const CallExpr *>(expr));
+  case ExprKind::STRING:
+    throw std::runtime_error("Strings are only allowed as function arguments.");
+  }
+  throw std::runtime_error("Unknown expression type.");
+}
+
+auto Compiler::emitBinary(const BinaryExpr *expr) -> uint32_t {
+  if (expr->op != TokenType::MULTIPLY) {
+    throw std::runtime_error("Unknown operator.");
+  }
+  std::vector<const Expression *> factors;
+  collectFactors(expr, factors);
+  const uint32_t dst = top;
+  for (const Expression *factor : factors) {
+    emit(factor);
+  }
+  top = dst + 1;
+
+  if (factors.size() == 2) {
+    program.code.push_back({OpCode::MUL, dst, dst, dst + 1});
+  } else {
+    program.code.push_back(
+        {OpCode::CHAIN, dst, static_cast<uint32_t>(factors.size()), 0});
+  }
+  return dst;
+}
+
+void Compiler::collectFactors(const Expression *expr,
+                              std::vector<const Expression *> &factors) {
+  if (expr->kind == ExprKind::BINARY && !isElementwise(expr) &&
+      static_cast<const BinaryExpr *>(expr)->op == TokenType::MULTIPLY) {
+    const auto *binary = static_cast<const BinaryExpr *>(expr);
+    collectFactors(binary->left, factors);
+    collectFactors(binary->right, factors);
+    return;
+  }
+  factors.push_back(expr);
+}
+
+auto Compiler::emitCall(const CallExpr *expr) -> uint32_t {
+  BuiltinCall call{findBuiltin(expr->name).function, {}};
+  // The result goes to the first register the call uses.
+  const uint32_t dst = top;
+  for (size_t i = 0; i < expr->argumentCount; ++i) {
+    const Expression *argument = expr->arguments[i];
+    if (argument->kind == ExprKind::STRING) {
+      const auto index = static_cast<uint32_t>(program.strings.size());
+      program.strings.emplace_back(
+          static_cast<const StringExpr *>(argument)->value);
+      call.arguments.push_back({CallArgument::Source::STRING, index});
+    } else {
+      call.arguments.push_back(
+          {CallArgument::Source::REGISTER, emit(argument)});
+    }
+  }
+  if (top == dst) {
+    allocate();
+  }
+  top = dst + 1;
+
+  const auto index = static_cast<uint32_t>(program.calls.size());
+  program.calls.push_back(std::move(call));
+  program.code.push_back({OpCode::CALL, dst, index, 0});
+  return dst;
+}
+
+auto Compiler::emitFused(const Expression *expr, uint32_t target)
+    -> uint32_t {
+  const uint32_t dst = allocate();
+  FusedKernel kernel;
+  uint32_t height = 0;
+  planFused(expr, kernel, height);
+  top = dst + 1;
+
+  const auto index = static_cast<uint32_t>(program.kernels.size());
+  program.kernels.push_back(std::move(kernel));
+  program.code.push_back({OpCode::FUSED, dst, index, target});
+  return dst;
+}
+
+void Compiler::planFused(const Expression *expr, FusedKernel &kernel,
+                         uint32_t &height) {
+  if (!isElementwise(expr)) {
+    FusedOperand operand{};
+    switch (expr->kind) {
+    case ExprKind::VARIABLE:
+      operand = {FusedOperand::Source::VARIABLE,
+                 nameSlot(static_cast<const VariableExpr *>(expr)->name)};
+      break;
+    case ExprKind::LITERAL:
+    case ExprKind::NUMBER:
+      operand = {FusedOperand::Source::CONSTANT, constant(expr)};
+      break;
+    default:
+      operand = {FusedOperand::Source::REGISTER, emit(expr)};
+      break;
+    }
+    const auto input = static_cast<uint32_t>(kernel.operands.size());
+    kernel.operands.push_back(operand);
+    kernel.steps.push_back({FusedStep::Kind::INPUT, input, 0.0});
+    kernel.depth = std::max(kernel.depth, ++height);
+    return;
+  }
+
+  const auto *binary = static_cast<const BinaryExpr *>(expr);
+  if (binary->op == TokenType::MULTIPLY) {
+    double factor = 0.0;
+    const Expression *operand = binary->left;
+    if (!scalarLiteral(binary->right, factor)) {
+      scalarLiteral(binary->left, factor);
+      operand = binary->right;
+    }
+    planFused(operand, kernel, height);
+    kernel.steps.push_back({FusedStep::Kind::SCALE, 0, factor});
+    return;
+  }
+
+  planFused(binary->left, kernel, height);
+  planFused(binary->right, kernel, height);
+  kernel.steps.push_back({binary->op == TokenType::PLUS
+                              ? FusedStep::Kind::ADD
+                              : FusedStep::Kind::SUB,
+                          0, 0.0});
+  --height;
+}
+
+auto Compiler::isElementwise(const Expression *expr) -> bool {
+  if (expr->kind != ExprKind::BINARY) {
+    return false;
+  }
+  const auto *binary = static_cast<const BinaryExpr *>(expr);
+  double factor = 0.0;
+  switch (binary->op) {
+  case TokenType::PLUS:
+  case TokenType::MINUS:
+    return true;
+  case TokenType::MULTIPLY:
+    return scalarLiteral(binary->left, factor) ||
+           scalarLiteral(binary->right, factor);
+  default:
+    return false;
+  }
+}
+
+auto Compiler::scalarLiteral(const Expression *expr, double &value) -> bool {
+  if (expr->kind == ExprKind::NUMBER) {
+    value = static_cast<const NumberExpr *>(expr)->value;
+    return true;
+  }
+  if (expr->kind == ExprKind::LITERAL) {
+    const Matrix<double> &matrix =
+        static_cast<const LiteralExpr *>(expr)->value;
+    if (matrix.getRows() == 1 && matrix.getCols() == 1) {
+      value = matrix(0, 0);
+      return true;
+    }
+  }
+  return false;
+}
+
+auto Compiler::constant(const Expression *expr) -> uint32_t {
+  const auto index = static_cast<uint32_t>(program.constants.size());
+  double scalar = 0.0;
+  if (scalarLiteral(expr, scalar)) {
+    program.constants.emplace_back(scalar);
+  } else {
+    program.constants.emplace_back(
+        static_cast<const LiteralExpr *>(expr)->value);
+  }
+  return index;
+}
+
+auto Compiler::allocate() -> uint32_t {
+  const uint32_t reg = top++;
+  if (top > program.registerCount) {
+    program.registerCount = top;
+  }
+  return reg;
+}
+
+auto Compiler::nameSlot(std::string_view name) -> uint32_t {
+  auto it = nameSlots.find(name);
+  if (it != nameSlots.end()) {
+    return it->second;
+  }
+  const auto slot = static_cast<uint32_t>(program.names.size());
+  program.names.emplace_back(name);
+  nameSlots.emplace(name, slot);
+  return slot;
+}
@@ -0,0 +1,178 @@
+#include "CsvReader.h"
+#include "Lexer.h"
+#include "MappedFile.h"
+#include "ThreadPool.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Chunks smaller than this are not worth a task of their own.
+ */
+constexpr size_t MIN_CHUNK_BYTES = 1 << 20;
+
+auto isBlank(char c) -> bool { return c == ' ' || c == '\t' || c == '\r'; }
+
+auto skipBlanks(const char *p, const char *last) -> const char * {
+  while (p != last && isBlank(*p)) {
+    ++p;
+  }
+  return p;
+}
+
+/**
+ * @brief End of the line starting at p, excluding the newline.
+ */
+auto lineEnd(const char *p, const char *last) -> const char * {
+  const void *newline = std::memchr(p, '\n', static_cast<size_t>(last - p));
+  return newline != nullptr ? static_cast<const char *>(newline) : last;
+}
+
+/**
+ * @brief Parse one line into out, which has room for at most capacity
+ * values.
+ *
+ * @return size_t Number of values on the line, or SIZE_MAX if a field is
+ * not a number. Values beyond capacity are counted but not stored.
+ */
+auto parseLine(const char *p, const char *last, double *out, size_t capacity)
+    -> size_t {
+  size_t count = 0;
+  p = skipBlanks(p, last);
+  while (p != last) {
+    const bool negative = *p == '-';
+    if (*p == '-' || *p == '+') {
+      ++p;
+    }
+    double value = 0.0;
+    p = Lexer::scanNumber(p, last, value);
+    if (p == nullptr) {
+      return SIZE_MAX;
+    }
+    if (count < capacity) {
+      out[count] = negative ? -value : value;
+    }
+    ++count;
+
+    p = skipBlanks(p, last);
+    if (p != last && *p == ',') {
+      p = skipBlanks(p + 1, last);
+      if (p == last) {
+        return SIZE_MAX;
+      }
+    }
+  }
+  return count;
+}
+
+/**
+ * @brief A line-aligned slice of the file and where its rows go.
+ */
+struct Chunk {
+  const char *begin;
+  const char *end;
+  size_t firstLine = 0;
+  size_t lines = 0;
+  size_t firstRow = 0;
+  size_t rows = 0;
+};
+
+} // namespace
+
+auto readCsv(const std::string &path) -> Matrix<double> {
+  const MappedFile file(path);
+  const char *text = reinterpret_cast<const char *>(file.data());
+  const char *last = text + file.size();
+
+  // The first non-blank line fixes the column count, unless it is a header.
+  const char *body = text;
+  size_t bodyLine = 1;
+  size_t cols = 0;
+  bool header = false;
+  while (body != last) {
+    const char *end = lineEnd(body, last);
+    if (skipBlanks(body, end) != end) {
+      cols = parseLine(body, end, nullptr, 0);
+      if (cols != SIZE_MAX || header) {
+        break;
+      }
+      header = true;
+    }
+    body = end == last ? last : end + 1;
+    ++bodyLine;
+  }
+  if (body == last) {
+    return {};
+  }
+  if (cols == SIZE_MAX) {
+    throw std::runtime_error("Invalid number on line " +
+                             std::to_string(bodyLine) + " of '" + path + "'.");
+  }
+
+  ThreadPool &pool = ThreadPool::instance();
+  const auto bytes = static_cast<size_t>(last - body);
+  const size_t chunkCount = std::max<size_t>(
+      1, std::min(pool.threadCount() * 4, bytes / MIN_CHUNK_BYTES));
+  std::vector<Chunk> chunks;
+  for (const char *begin = body; begin != last;) {
+    const char *end = last;
+    if (chunks.size() + 1 < chunkCount) {
+      end = std::min(last, begin + bytes / chunkCount);
+      end = end == last ? last : lineEnd(end, last);
+      end = end == last ? last : end + 1;
+    }
+    chunks.push_back({begin, end});
+    begin = end;
+  }
+
+  // Count the lines and rows of each chunk, then place the chunks.
+  pool.parallelFor(chunks.size(), [&chunks](size_t c) {
+    Chunk &chunk = chunks[c];
+    for (const char *p = chunk.begin; p != chunk.end;) {
+      const char *end = lineEnd(p, chunk.end);
+      chunk.rows += skipBlanks(p, end) != end ? 1 : 0;
+      ++chunk.lines;
+      p = end == chunk.end ? end : end + 1;
+    }
+  });
+  size_t rows = 0;
+  size_t line = bodyLine;
+  for (Chunk &chunk : chunks) {
+    chunk.firstRow = rows;
+    chunk.firstLine = line;
+    rows += chunk.rows;
+    line += chunk.lines;
+  }
+
+  Matrix<double> result = Matrix<double>::uninitialized(rows, cols);
+  double *out = result.raw();
+  pool.parallelFor(chunks.size(), [&](size_t c) {
+    const Chunk &chunk = chunks[c];
+    double *row = out + chunk.firstRow * cols;
+    size_t lineNumber = chunk.firstLine;
+    for (const char *p = chunk.begin; p != chunk.end; ++lineNumber) {
+      const char *end = lineEnd(p, chunk.end);
+      if (skipBlanks(p, end) != end) {
+        const size_t count = parseLine(p, end, row, cols);
+        if (count == SIZE_MAX) {
+          throw std::runtime_error("Invalid number on line " +
+                                   std::to_string(lineNumber) + " of '" +
+                                   path + "'.");
+        }
+        if (count != cols) {
+          throw std::runtime_error(
+              "Expected " + std::to_string(cols) + " values on line " +
+              std::to_string(lineNumber) + " of '" + path + "'.");
+        }
+        row += cols;
+      }
+      p = end == chunk.end ? end : end + 1;
+    }
+  });
+  return result;
+}
@@ -0,0 +1,208 @@
+#include "Fusion.h"
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+namespace {
+
+/**
+ * @brief A stack entry of the chunked evaluation: a chunk of values, or a
+ * broadcast scalar when data is null.
+ */
+template <typename T> struct Slot {
+  const T *data;
+  T value;
+};
+
+} // namespace
+
+auto fusedShape(const FusedKernel &kernel,
+                const std::vector<const Value *> &inputs)
+    -> std::pair<size_t, size_t> {
+  std::vector<std::pair<size_t, size_t>> stack;
+  for (const FusedStep &step : kernel.steps) {
+    switch (step.kind) {
+    case FusedStep::Kind::INPUT:
+      stack.emplace_back(inputs[step.input]->getRows(),
+                         inputs[step.input]->getCols());
+      break;
+    case FusedStep::Kind::ADD:
+    case FusedStep::Kind::SUB: {
+      const auto b = stack.back();
+      stack.pop_back();
+      auto &a = stack.back();
+      if (a == b || b.first * b.second == 1) {
+        break;
+      }
+      if (a.first * a.second == 1) {
+        a = b;
+        break;
+      }
+      throw std::invalid_argument(
+          std::string("Matrix dimensions must match for ") +
+          (step.kind == FusedStep::Kind::ADD ? "addition" : "subtraction"));
+    }
+    case FusedStep::Kind::SCALE:
+      break;
+    }
+  }
+  return stack.back();
+}
+
+template <typename T>
+void evaluateFused(const FusedKernel &kernel,
+                   const std::vector<const Value *> &inputs, Matrix<T> &out) {
+  const auto [rows, cols] = fusedShape(kernel, inputs);
+  // A shared destination gets a fresh buffer rather than a copy it would
+  // overwrite anyway.
+  if (out.getRows() != rows || out.getCols() != cols || out.isShared()) {
+    Matrix<T> result = Matrix<T>::uninitialized(rows, cols);
+    evaluateFused(kernel, inputs, result);
+    out = std::move(result);
+    return;
+  }
+
+  const size_t n = out.size();
+  const simd::Store store = n * sizeof(T) > simd::streamingThreshold()
+                                ? simd::Store::STREAM
+                                : simd::Store::CACHED;
+  std::vector<T, AlignedAllocator<T>> scratch(size_t(kernel.depth) *
+                                              expr::CHUNK);
+  std::vector<Slot<T>> stack(kernel.depth);
+  T *dst = out.raw();
+  const size_t last = kernel.steps.size() - 1;
+
+  for (size_t offset = 0; offset < n; offset += expr::CHUNK) {
+    const size_t len = std::min(expr::CHUNK, n - offset);
+    size_t height = 0;
+    for (size_t s = 0; s <= last; ++s) {
+      const FusedStep &step = kernel.steps[s];
+      if (step.kind == FusedStep::Kind::INPUT) {
+        const Value &input = *inputs[step.input];
+        stack[height++] =
+            input.size() == 1
+                ? Slot<T>{nullptr, static_cast<T>(input(0, 0))}
+                : Slot<T>{input.get<Matrix<T>>().raw() + offset, T()};
+        continue;
+      }
+
+      const size_t slot =
+          step.kind == FusedStep::Kind::SCALE ? height - 1 : height - 2;
+      T *target =
+          s == last ? dst + offset : scratch.data() + slot * expr::CHUNK;
+      const simd::Store policy = s == last ? store : simd::Store::CACHED;
+      const Slot<T> a = stack[slot];
+      Slot<T> result{target, T()};
+
+      switch (step.kind) {
+      case FusedStep::Kind::ADD:
+      case FusedStep::Kind::SUB: {
+        const Slot<T> b = stack[slot + 1];
+        const bool add = step.kind == FusedStep::Kind::ADD;
+        const simd::Op op = add ? simd::Op::ADD : simd::Op::SUB;
+        if (a.data != nullptr && b.data != nullptr) {
+          simd::binary(op, a.data, b.data, target, len, policy);
+        } else if (a.data != nullptr) {
+          simd::broadcast(op, a.data, b.value, target, len, policy);
+        } else if (b.data == nullptr) {
+          result = {nullptr, simd::apply(op, a.value, b.value)};
+        } else if (add) {
+          simd::broadcast(op, b.data, a.value, target, len, policy);
+        } else {
+          // s - b as -b + s.
+          simd::broadcast(simd::Op::MUL, b.data, T(-1), target, len,
+                          simd::Store::CACHED);
+          simd::broadcast(simd::Op::ADD, target, a.value, target, len,
+                          policy);
+        }
+        break;
+      }
+      case FusedStep::Kind::SCALE: {
+        const auto factor = static_cast<T>(step.factor);
+        if (a.data != nullptr) {
+          simd::broadcast(simd::Op::MUL, a.data, factor, target, len, policy);
+        } else {
+          result = {nullptr, simd::apply(simd::Op::MUL, a.value, factor)};
+        }
+        break;
+      }
+      case FusedStep::Kind::INPUT:
+        break;
+      }
+      if (s == last && result.data == nullptr) {
+        std::fill(target, target + len, result.value);
+      }
+      stack[slot] = result;
+      height = slot + 1;
+    }
+  }
+}
+
+template void evaluateFused(const FusedKernel &,
+                            const std::vector<const Value *> &,
+                            Matrix<double> &);
+template void evaluateFused(const FusedKernel &,
+                            const std::vector<const Value *> &,
+                            Matrix<float> &);
+template void evaluateFused(const FusedKernel &,
+                            const std::vector<const Value *> &,
+                            Matrix<int32_t> &);
+
+auto evaluateFusedScalar(const FusedKernel &kernel,
+                         const std::vector<const Value *> &inputs)
+    -> double {
+  constexpr size_t INLINE_DEPTH = 16;
+  double inlineStack[INLINE_DEPTH] = {};
+  std::vector<double> heapStack;
+  double *stack = inlineStack;
+  if (kernel.depth > INLINE_DEPTH) {
+    heapStack.resize(kernel.depth);
+    stack = heapStack.data();
+  }
+
+  size_t height = 0;
+  for (const FusedStep &step : kernel.steps) {
+    switch (step.kind) {
+    case FusedStep::Kind::INPUT:
+      stack[height++] = (*inputs[step.input])(0, 0);
+      break;
+    case FusedStep::Kind::ADD:
+      --height;
+      stack[height - 1] += stack[height];
+      break;
+    case FusedStep::Kind::SUB:
+      --height;
+      stack[height - 1] -= stack[height];
+      break;
+    case FusedStep::Kind::SCALE:
+      stack[height - 1] *= step.factor;
+      break;
+    }
+  }
+  return stack[0];
+}
+
+auto evaluateFused(const FusedKernel &kernel,
+                   const std::vector<const Value *> &inputs) -> Value {
+  std::vector<Value> stack;
+  for (const FusedStep &step : kernel.steps) {
+    switch (step.kind) {
+    case FusedStep::Kind::INPUT:
+      stack.push_back(*inputs[step.input]);
+      break;
+    case FusedStep::Kind::ADD:
+    case FusedStep::Kind::SUB: {
+      Value b = std::move(stack.back());
+      stack.pop_back();
+      stack.back() =
+          add(stack.back(), b, step.kind == FusedStep::Kind::SUB);
+      break;
+    }
+    case FusedStep::Kind::SCALE:
+      stack.back() = scale(stack.back(), step.factor);
+      break;
+    }
+  }
+  return std::move(stack.back());
+}
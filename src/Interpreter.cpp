@@ -1,74 +1,607 @@
 #include "Interpreter.h"
+#include "Compiler.h"
+#include "CsvReader.h"
+#include "Fusion.h"
+#include "Lexer.h"
+#include "MatrixFile.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <optional>
 #include <stdexcept>
+#include <utility>
+#include <vector>
+
+namespace {
+
+auto operationOf(OpCode op) -> Profiler::Operation {
+  switch (op) {
+  case OpCode::LOAD_CONST:
+  case OpCode::LOAD_VAR:
+    return Profiler::Operation::LOAD;
+  case OpCode::STORE_VAR:
+    return Profiler::Operation::STORE;
+  case OpCode::FUSED:
+    return Profiler::Operation::ELEMENTWISE;
+  case OpCode::MUL:
+  case OpCode::CHAIN:
+    return Profiler::Operation::MULTIPLY;
+  case OpCode::CALL:
+    break;
+  }
+  return Profiler::Operation::CALL;
+}
+
+/**
+ * @brief Floating-point operations done by a kernel producing out.
+ */
+auto fusedFlops(const FusedKernel &kernel, const Value &out) -> uint64_t {
+  uint64_t perElement = 0;
+  for (const FusedStep &step : kernel.steps) {
+    perElement += step.kind != FusedStep::Kind::INPUT ? 1 : 0;
+  }
+  return perElement * out.size();
+}
+
+/**
+ * @brief Floating-point operations done by a * b: a GEMM, a sparse product
+ * or a scaling.
+ *
+ * Sparse times sparse is estimated as if the right operand were dense.
+ */
+auto multiplyFlops(const Value &a, const Value &b) -> uint64_t {
+  if (a.size() == 1 || b.size() == 1) {
+    return std::max(a.size(), b.size());
+  }
+  if (a.isSparse()) {
+    return 2ULL * a.sparse().nonZeros() * b.getCols();
+  }
+  if (b.isSparse()) {
+    return 2ULL * a.getRows() * b.sparse().nonZeros();
+  }
+  return 2ULL * a.getRows() * a.getCols() * b.getCols();
+}
+
+/**
+ * @brief Element type in which a fused kernel can run in one pass.
+ *
+ * That is the type of its matrix operands if they are all dense and of the
+ * same type, and the kernel keeps that type: an int32 kernel with a scalar
+ * or factor that is not an int32 would be promoted. Other kernels run
+ * step by step on values and have no single type.
+ */
+auto kernelType(const FusedKernel &kernel,
+                const std::vector<const Value *> &inputs)
+    -> std::optional<DType> {
+  std::optional<DType> type;
+  bool integral = true;
+  for (const Value *input : inputs) {
+    if (input->isScalar()) {
+      integral = integral && fitsInt32(input->scalar());
+      continue;
+    }
+    if (input->isSparse() || (type && *type != input->dtype())) {
+      return std::nullopt;
+    }
+    type = input->dtype();
+  }
+  for (const FusedStep &step : kernel.steps) {
+    integral = integral && fitsInt32(step.factor);
+  }
+  if (type == DType::INT32 && !integral) {
+    return std::nullopt;
+  }
+  return type;
+}
+
+/**
+ * @brief Cheapest multiplication order of a chain of matrices.
+ */
+struct ChainOrder {
+  std::vector<size_t> split; // Last split of factors i..j at i * n + j
+  uint64_t cost = 0;         // Multiply-adds of the whole chain
+};
+
+/**
+ * @brief Classic O(n^3) matrix-chain dynamic program.
+ *
+ * @param factors Matrices whose adjacent dimensions match.
+ */
+auto planChain(const std::vector<Value> &factors) -> ChainOrder {
+  const size_t n = factors.size();
+  auto dim = [&factors](size_t i) -> uint64_t {
+    return i == 0 ? factors[0].getRows() : factors[i - 1].getCols();
+  };
+  std::vector<uint64_t> cost(n * n, 0);
+  ChainOrder order;
+  order.split.assign(n * n, 0);
+  for (size_t length = 2; length <= n; ++length) {
+    for (size_t i = 0; i + length <= n; ++i) {
+      const size_t j = i + length - 1;
+      cost[i * n + j] = UINT64_MAX;
+      for (size_t k = i; k < j; ++k) {
+        const uint64_t total = cost[i * n + k] + cost[(k + 1) * n + j] +
+                               dim(i) * dim(k + 1) * dim(j + 1);
+        if (total < cost[i * n + j]) {
+          cost[i * n + j] = total;
+          order.split[i * n + j] = k;
+        }
+      }
+    }
+  }
+  order.cost = cost[n - 1];
+  return order;
+}
+
+} // namespace
 
 auto Interpreter::interpret(const std::shared_ptr<Expression> &expression,
-                            bool printResult) -> Matrix<double> {
+                            bool printResult) -> Value {
   shouldPrint = printResult;
-  lastResult = evaluate(expression);
-  variables["ans"] = lastResult;
-  return lastResult;
+  std::shared_ptr<const Program> program;
+  {
+    Profiler::Scope scope(Profiler::Phase::COMPILE);
+    program = Compiler::compile(expression, printResult);
+  }
+  return execute(*program);
 }
 
-auto Interpreter::evaluate(const std::shared_ptr<Expression> &expr)
-    -> Matrix<double> {
-  if (auto *literalExpr = dynamic_cast<LiteralExpr *>(expr.get())) {
-    return evaluateLiteral(literalExpr);
+auto Interpreter::compile(const std::string &source)
+    -> std::shared_ptr<const Program> {
+  auto cached = programCache.find(source);
+  if (cached != programCache.end()) {
+    return cached->second;
   }
-  if (auto *binaryExpr = dynamic_cast<BinaryExpr *>(expr.get())) {
-    return evaluateBinary(binaryExpr);
+
+  std::vector<Token> tokens;
+  {
+    Profiler::Scope scope(Profiler::Phase::LEX);
+    tokens = Lexer(source).scanTokens();
   }
-  if (auto *variableExpr = dynamic_cast<VariableExpr *>(expr.get())) {
-    return evaluateVariable(variableExpr);
+  std::shared_ptr<Expression> expression;
+  {
+    Profiler::Scope scope(Profiler::Phase::PARSE);
+    expression = Parser(tokens).parse();
   }
-  if (auto *assignExpr = dynamic_cast<AssignExpr *>(expr.get())) {
-    return evaluateAssign(assignExpr);
+  Profiler::Scope scope(Profiler::Phase::COMPILE);
+
+  // Don't print if the statement ends with semicolon
+  const bool printResult =
+      tokens.size() < 2 ||
+      tokens[tokens.size() - 2].type != TokenType::SEMICOLON;
+  auto program = Compiler::compile(expression, printResult);
+
+  if (programCache.size() >= PROGRAM_CACHE_LIMIT) {
+    programCache.clear();
   }
-  throw std::runtime_error("Unknown expression type.");
+  programCache.emplace(source, program);
+  return program;
 }
 
-auto Interpreter::evaluateBinary(const BinaryExpr *expr) -> Matrix<double> {
-  Matrix<double> left = evaluate(expr->left);
-  Matrix<double> right = evaluate(expr->right);
+auto Interpreter::execute(const Program &program) -> Value {
+  Profiler::Scope scope(Profiler::Phase::EVAL);
+  shouldPrint = program.printResult;
+  if (registers.size() < program.registerCount) {
+    registers.resize(program.registerCount);
+  }
 
-  switch (expr->op.type) {
-  case TokenType::PLUS:
-    return left + right;
-  case TokenType::MINUS:
-    return left - right;
-  case TokenType::MULTIPLY:
-    return left * right;
-  default:
-    throw std::runtime_error("Unknown operator.");
+  auto releaseRegisters = [this, &program]() {
+    for (uint32_t i = 0; i < program.registerCount; ++i) {
+      registers[i] = Value();
+    }
+  };
+
+  try {
+    run(program);
+  } catch (...) {
+    releaseRegisters();
+    throw;
+  }
+
+  lastResult = std::move(registers[program.result]);
+  releaseRegisters();
+  if (program.setsAns) {
+    store("ans", lastResult);
   }
+  return lastResult;
 }
 
-auto Interpreter::evaluateLiteral(const LiteralExpr *expr) -> Matrix<double> {
-  return expr->value;
+void Interpreter::run(const Program &program) {
+  for (const Instruction &ins : program.code) {
+    if (deadline != NO_DEADLINE &&
+        std::chrono::steady_clock::now() > deadline) {
+      throw std::runtime_error("Time limit exceeded.");
+    }
+    Profiler::Scope scope(operationOf(ins.op));
+    switch (ins.op) {
+    case OpCode::LOAD_CONST:
+      registers[ins.dst] = program.constants[ins.a];
+      break;
+    case OpCode::LOAD_VAR:
+      registers[ins.dst] = lookup(program.names[ins.a]);
+      break;
+    case OpCode::STORE_VAR:
+      store(program.names[ins.a], registers[ins.b]);
+      break;
+    case OpCode::FUSED:
+      runFused(program, ins);
+      if (scope.active()) {
+        scope.addFlops(
+            fusedFlops(program.kernels[ins.a], registers[ins.dst]));
+      }
+      break;
+    case OpCode::MUL:
+      if (scope.active()) {
+        scope.addFlops(multiplyFlops(registers[ins.a], registers[ins.b]));
+      }
+      registers[ins.dst] =
+          multiply(registers[ins.a], registers[ins.b], matMulAlgorithm);
+      break;
+    case OpCode::CHAIN: {
+      const uint64_t flops = runChain(ins);
+      scope.addFlops(flops);
+      break;
+    }
+    case OpCode::CALL:
+      registers[ins.dst] = runCall(program, program.calls[ins.a]);
+      break;
+    }
+  }
 }
 
-auto Interpreter::evaluateVariable(const VariableExpr *expr) -> Matrix<double> {
-  auto it = variables.find(expr->name.lexeme);
-  if (it != variables.end()) {
-    return it->second;
+void Interpreter::runFused(const Program &program, const Instruction &ins) {
+  const FusedKernel &kernel = program.kernels[ins.a];
+  fusedValues.clear();
+  bool scalar = true;
+  for (const FusedOperand &operand : kernel.operands) {
+    switch (operand.source) {
+    case FusedOperand::Source::REGISTER:
+      fusedValues.push_back(&registers[operand.index]);
+      break;
+    case FusedOperand::Source::VARIABLE:
+      fusedValues.push_back(&lookup(program.names[operand.index]));
+      break;
+    case FusedOperand::Source::CONSTANT:
+      fusedValues.push_back(&program.constants[operand.index]);
+      break;
+    }
+    scalar = scalar && fusedValues.back()->size() == 1 &&
+             fusedValues.back()->dtype() == DType::FLOAT64;
+  }
+
+  // Scalar arithmetic never allocates: the result stays unboxed and
+  // overwrites the destination in place.
+  if (scalar) {
+    const double result = evaluateFusedScalar(kernel, fusedValues);
+    registers[ins.dst] = result;
+    if (ins.b != NO_OPERAND) {
+      const std::string &name = program.names[ins.b];
+      if (Value *target = find(name)) {
+        *target = result;
+        modified = true;
+      } else {
+        store(name, result);
+      }
+    }
+    return;
+  }
+
+  // Sparse and mixed-type operands go through the value operations, which
+  // keep sums of sparse matrices sparse and promote mixed types.
+  const std::optional<DType> type = kernelType(kernel, fusedValues);
+  if (!type) {
+    registers[ins.dst] = evaluateFused(kernel, fusedValues);
+    if (ins.b != NO_OPERAND) {
+      store(program.names[ins.b], registers[ins.dst]);
+    }
+    return;
+  }
+  switch (*type) {
+  case DType::INT32:
+    runFusedAs<int32_t>(program, ins);
+    return;
+  case DType::FLOAT32:
+    runFusedAs<float>(program, ins);
+    return;
+  case DType::FLOAT64:
+    break;
+  }
+  runFusedAs<double>(program, ins);
+}
+
+template <typename T>
+void Interpreter::runFusedAs(const Program &program, const Instruction &ins) {
+  const FusedKernel &kernel = program.kernels[ins.a];
+  if (ins.b == NO_OPERAND) {
+    Matrix<T> result;
+    evaluateFused(kernel, fusedValues, result);
+    registers[ins.dst] = std::move(result);
+    return;
+  }
+
+  // Write into the destination variable's buffer when it already exists
+  // with the result's type; a new variable is only created once evaluation
+  // has succeeded.
+  const std::string &name = program.names[ins.b];
+  Value *target = find(name);
+  if (target != nullptr && target->holds<Matrix<T>>()) {
+    // 'ans' and the last result usually share the target's buffer, from
+    // the statement that assigned it. When this write produces the
+    // statement's value they are about to be replaced anyway: release them,
+    // once the shapes are known to fit, so the buffer can be reused.
+    Value *ans = find("ans");
+    if (program.setsAns && &ins == &program.code.back() && ans != target &&
+        std::find(fusedValues.begin(), fusedValues.end(), ans) ==
+            fusedValues.end()) {
+      fusedShape(kernel, fusedValues);
+      lastResult = Value();
+      if (ans != nullptr) {
+        *ans = Value();
+      }
+    }
+    evaluateFused(kernel, fusedValues, target->get<Matrix<T>>());
+    modified = true;
+    registers[ins.dst] = *target;
+  } else {
+    Matrix<T> result;
+    evaluateFused(kernel, fusedValues, result);
+    registers[ins.dst] = std::move(result);
+    store(name, registers[ins.dst]);
   }
-  throw std::runtime_error("Undefined variable '" + expr->name.lexeme + "'.");
 }
 
-auto Interpreter::evaluateAssign(const AssignExpr *expr) -> Matrix<double> {
-  Matrix<double> value = evaluate(expr->value);
-  variables[expr->name.lexeme] = value;
-  return value;
+auto Interpreter::runChain(const Instruction &ins) -> uint64_t {
+  std::vector<Value> operands;
+  for (uint32_t i = 0; i < ins.a; ++i) {
+    operands.push_back(std::move(registers[ins.dst + i]));
+    registers[ins.dst + i] = Value();
+  }
+  auto isScalar = [](const Value &value) {
+    return value.getRows() == 1 && value.getCols() == 1;
+  };
+
+  // The matrices only fail to chain when a 1x1 intermediate product makes
+  // them fit, as in [1, 2] * [3; 4] * B, and there is nothing to reorder
+  // without matrices. Reordering must also give every step the element type
+  // it has from left to right: the matrices share one type, and 1x1 factors
+  // are float64 or of that type and keep an int32 product int32. Otherwise
+  // multiply from left to right, which also keeps a product of scalars
+  // unboxed.
+  const Value *previous = nullptr;
+  bool chained = true;
+  for (const Value &operand : operands) {
+    if (!isScalar(operand)) {
+      chained = chained && (previous == nullptr ||
+                            (previous->getCols() == operand.getRows() &&
+                             previous->dtype() == operand.dtype()));
+      previous = &operand;
+    }
+  }
+  const DType type = previous != nullptr ? previous->dtype() : DType::FLOAT64;
+  for (const Value &operand : operands) {
+    if (isScalar(operand)) {
+      chained = chained &&
+                (operand.dtype() == DType::FLOAT64 ||
+                 operand.dtype() == type) &&
+                (type != DType::INT32 || fitsInt32(operand(0, 0)));
+    }
+  }
+  if (!chained || previous == nullptr) {
+    Value result = std::move(operands.front());
+    uint64_t flops = 0;
+    for (size_t i = 1; i < operands.size(); ++i) {
+      flops += multiplyFlops(result, operands[i]);
+      result = multiply(result, operands[i], matMulAlgorithm);
+    }
+    registers[ins.dst] = std::move(result);
+    return flops;
+  }
+
+  // 1x1 factors scale the product, as in Matrix::operator*. Float64 ones
+  // fold into one scalar; others are applied one by one, so float32
+  // products round and int32 products wrap at each step as they would from
+  // left to right.
+  std::vector<Value> factors;
+  std::vector<double> scalars;
+  for (Value &operand : operands) {
+    if (!isScalar(operand)) {
+      factors.push_back(std::move(operand));
+    } else if (type == DType::FLOAT64 && !scalars.empty()) {
+      scalars.back() *= operand(0, 0);
+    } else {
+      scalars.push_back(operand(0, 0));
+    }
+  }
+  auto scaled = [&scalars](Value value) {
+    for (const double s : scalars) {
+      value = scale(value, s);
+    }
+    return value;
+  };
+  const ChainOrder order = planChain(factors);
+  const size_t n = factors.size();
+  uint64_t flops = 2 * order.cost;
+
+  // Scale the smallest operand, or the result if it is smaller still.
+  bool scaleResult = false;
+  if (!scalars.empty()) {
+    auto smallest = std::min_element(
+        factors.begin(), factors.end(),
+        [](const auto &a, const auto &b) { return a.size() < b.size(); });
+    const size_t resultSize = factors.front().getRows() *
+                              factors.back().getCols();
+    if (smallest->size() <= resultSize) {
+      *smallest = scaled(std::move(*smallest));
+      flops += scalars.size() * smallest->size();
+    } else {
+      scaleResult = true;
+      flops += scalars.size() * resultSize;
+    }
+  }
+
+  auto product = [&](auto &self, size_t i, size_t j) -> Value {
+    if (i == j) {
+      return std::move(factors[i]);
+    }
+    const size_t k = order.split[i * n + j];
+    const Value left = self(self, i, k);
+    return multiply(left, self(self, k + 1, j), matMulAlgorithm);
+  };
+  Value result = product(product, 0, n - 1);
+  if (scaleResult) {
+    result = scaled(std::move(result));
+  }
+  registers[ins.dst] = std::move(result);
+  return flops;
 }
 
-void Interpreter::setVariable(const std::string &name,
-                              const Matrix<double> &value) {
-  variables[name] = value;
+auto Interpreter::runCall(const Program &program, const BuiltinCall &call)
+    -> Value {
+  auto expect = [&call](size_t count, const char *usage) {
+    if (call.arguments.size() != count) {
+      throw std::runtime_error(std::string("Usage: ") + usage + ".");
+    }
+  };
+  auto matrix = [this, &call](size_t i, const char *usage)
+      -> const Value & {
+    if (call.arguments[i].source != CallArgument::Source::REGISTER) {
+      throw std::runtime_error(std::string("Usage: ") + usage + ".");
+    }
+    return registers[call.arguments[i].index];
+  };
+  auto string = [&program, &call](size_t i, const char *usage)
+      -> const std::string & {
+    if (call.arguments[i].source != CallArgument::Source::STRING) {
+      throw std::runtime_error(std::string("Usage: ") + usage + ".");
+    }
+    return program.strings[call.arguments[i].index];
+  };
+
+  switch (call.function) {
+  case Builtin::LOAD: {
+    const char *usage = "load(\"file\")";
+    expect(1, usage);
+    return loadMatrix(string(0, usage));
+  }
+  case Builtin::SAVE: {
+    const char *usage = "save(A, \"file\")";
+    expect(2, usage);
+    saveMatrix(matrix(0, usage), string(1, usage));
+    return {};
+  }
+  case Builtin::READ_CSV: {
+    const char *usage = "readcsv(\"file\")";
+    expect(1, usage);
+    return readCsv(string(0, usage));
+  }
+  case Builtin::SAVE_WS: {
+    const char *usage = "savews(\"file\")";
+    expect(1, usage);
+    saveWorkspace(string(0, usage));
+    return {};
+  }
+  case Builtin::LOAD_WS: {
+    const char *usage = "loadws(\"file\")";
+    expect(1, usage);
+    loadWorkspace(string(0, usage));
+    modified = true;
+    return {};
+  }
+  case Builtin::SPARSE: {
+    const char *usage = "sparse(A)";
+    expect(1, usage);
+    const Value &value = matrix(0, usage);
+    if (value.isSparse()) {
+      return value;
+    }
+    return SparseMatrix<double>::fromDense(value.toDense());
+  }
+  case Builtin::DENSE: {
+    const char *usage = "dense(A)";
+    expect(1, usage);
+    const Value &value = matrix(0, usage);
+    if (value.isSparse()) {
+      return value.toDense();
+    }
+    return value;
+  }
+  case Builtin::SINGLE: {
+    const char *usage = "single(A)";
+    expect(1, usage);
+    return matrix(0, usage).convert(DType::FLOAT32);
+  }
+  case Builtin::DOUBLE: {
+    const char *usage = "double(A)";
+    expect(1, usage);
+    return matrix(0, usage).convert(DType::FLOAT64);
+  }
+  case Builtin::INT32: {
+    const char *usage = "int32(A)";
+    expect(1, usage);
+    return matrix(0, usage).convert(DType::INT32);
+  }
+  }
+  throw std::runtime_error("Unknown function.");
+}
+
+auto Interpreter::lookup(const std::string &name) -> const Value & {
+  if (const Value *value = find(name)) {
+    return *value;
+  }
+  throw std::runtime_error("Undefined variable '" + name + "'.");
 }
 
-auto Interpreter::getVariable(const std::string &name) -> Matrix<double> {
+auto Interpreter::find(const std::string &name) -> Value * {
   auto it = variables.find(name);
   if (it != variables.end()) {
-    return it->second;
+    return &it->second;
   }
-  throw std::runtime_error("Undefined variable '" + name + "'.");
+  auto stored = storedVariables.find(name);
+  if (stored == storedVariables.end()) {
+    return nullptr;
+  }
+  Value value =
+      mapMatrix(stored->second.file, stored->second.offset, name);
+  storedVariables.erase(stored);
+  return &variables.emplace(name, std::move(value)).first->second;
+}
+
+void Interpreter::store(const std::string &name, Value value) {
+  storedVariables.erase(name);
+  variables[name] = std::move(value);
+  modified = true;
+}
+
+void Interpreter::setVariable(const std::string &name, Value value) {
+  store(name, std::move(value));
+}
+
+void Interpreter::saveWorkspace(const std::string &path) {
+  // Variables that were never used are mapped again only to be copied.
+  std::vector<Value> mapped;
+  mapped.reserve(storedVariables.size());
+  std::vector<std::pair<std::string, const Value *>> snapshot;
+  snapshot.reserve(variables.size() + storedVariables.size());
+  for (const auto &variable : variables) {
+    snapshot.emplace_back(variable.first, &variable.second);
+  }
+  for (const auto &stored : storedVariables) {
+    mapped.push_back(
+        mapMatrix(stored.second.file, stored.second.offset, stored.first));
+    snapshot.emplace_back(stored.first, &mapped.back());
+  }
+  std::sort(snapshot.begin(), snapshot.end(),
+            [](const auto &a, const auto &b) { return a.first < b.first; });
+  ::saveWorkspace(path, snapshot);
+}
+
+void Interpreter::loadWorkspace(const std::string &path) {
+  for (auto &variable : openWorkspace(path)) {
+    variables.erase(variable.first);
+    storedVariables.insert_or_assign(std::move(variable.first),
+                                     std::move(variable.second));
+  }
+}
+
+auto Interpreter::getVariable(const std::string &name) -> Value {
+  return lookup(name);
 }
@@ -1,4 +1,6 @@
 #include "Lexer.h"
+#include <charconv>
+#include <stdexcept>
 
 auto Lexer::isAtEnd() const -> bool { return current >= input.length(); }
 
@@ -45,25 +47,74 @@ void Lexer::skipWhitespace() {
 }
 
 auto Lexer::number() -> Token {
-  while (isDigit(peek())) {
-    advance();
+  double value = 0.0;
+  const char *first = input.data() + start;
+  const char *end = scanNumber(first, input.data() + input.size(), value);
+  if (end == nullptr) {
+    throw std::runtime_error("Invalid number.");
   }
+  current = static_cast<size_t>(end - input.data());
+  return {TokenType::NUMBER, input.substr(start, current - start), value,
+          line};
+}
 
-  if (peek() == '.' && isDigit(peekNext())) {
-    advance();
-    while (isDigit(peek())) {
-      advance();
+auto Lexer::scanNumber(const char *first, const char *last, double &value)
+    -> const char * {
+  const char *p = first;
+  while (p != last && isDigit(*p)) {
+    ++p;
+  }
+  if (p != last && *p == '.' && p + 1 != last && isDigit(p[1])) {
+    p += 2;
+    while (p != last && isDigit(*p)) {
+      ++p;
     }
   }
+  if (p == first) {
+    return nullptr;
+  }
+  // An exponent is only part of the number if it has digits.
+  if (p != last && (*p == 'e' || *p == 'E')) {
+    const char *exponent = p + 1;
+    if (exponent != last && (*exponent == '+' || *exponent == '-')) {
+      ++exponent;
+    }
+    if (exponent != last && isDigit(*exponent)) {
+      p = exponent;
+      while (p != last && isDigit(*p)) {
+        ++p;
+      }
+    }
+  }
+
+  const auto [end, error] = std::from_chars(first, p, value);
+  if (error != std::errc() || end != p) {
+    return nullptr;
+  }
+  return p;
+}
 
-  return {TokenType::NUMBER, input.substr(start, current - start)};
+auto Lexer::string() -> Token {
+  while (peek() != '"' && peek() != '\n' && !isAtEnd()) {
+    advance();
+  }
+  if (!match('"')) {
+    return make(TokenType::ERROR);
+  }
+  // The lexeme excludes the quotes.
+  return {TokenType::STRING, input.substr(start + 1, current - start - 2), 0.0,
+          line};
 }
 
 auto Lexer::identifier() -> Token {
   while (isAlphaNumeric(peek())) {
     advance();
   }
-  return {TokenType::IDENTIFIER, input.substr(start, current - start)};
+  return make(TokenType::IDENTIFIER);
+}
+
+auto Lexer::make(TokenType type) const -> Token {
+  return {type, input.substr(start, current - start), 0.0, line};
 }
 
 auto Lexer::isDigit(char c) -> bool { return c >= '0' && c <= '9'; }
@@ -79,7 +130,7 @@ auto Lexer::scanToken() -> Token {
   start = current;
 
   if (isAtEnd()) {
-    return {TokenType::END, ""};
+    return make(TokenType::END);
   }
 
   char c = advance();
@@ -93,37 +144,61 @@ auto Lexer::scanToken() -> Token {
 
   switch (c) {
   case '(':
-    return {TokenType::LPAREN, "("};
+    return make(TokenType::LPAREN);
   case ')':
-    return {TokenType::RPAREN, ")"};
+    return make(TokenType::RPAREN);
   case '[':
-    return {TokenType::LBRACKET, "["};
+    return make(TokenType::LBRACKET);
   case ']':
-    return {TokenType::RBRACKET, "]"};
+    return make(TokenType::RBRACKET);
   case ',':
-    return {TokenType::COMMA, ","};
+    return make(TokenType::COMMA);
   case '+':
-    return {TokenType::PLUS, "+"};
+    if (match('=')) {
+      return make(TokenType::PLUS_ASSIGN);
+    }
+    return make(TokenType::PLUS);
   case '-':
-    return {TokenType::MINUS, "-"};
+    if (match('=')) {
+      return make(TokenType::MINUS_ASSIGN);
+    }
+    return make(TokenType::MINUS);
   case '*':
-    return {TokenType::MULTIPLY, "*"};
+    if (match('=')) {
+      return make(TokenType::MULTIPLY_ASSIGN);
+    }
+    return make(TokenType::MULTIPLY);
   case '=':
-    return {TokenType::ASSIGN, "="};
+    return make(TokenType::ASSIGN);
   case ';':
-    return {TokenType::SEMICOLON, ";"};
-  case '\n':
-    return {TokenType::EOL, "\n"};
+    return make(TokenType::SEMICOLON);
+  case '"':
+    return string();
+  case '\n': {
+    Token eol = make(TokenType::EOL);
+    ++line;
+    return eol;
+  }
   }
 
-  throw std::runtime_error("Unexpected character");
+  return make(TokenType::ERROR);
 }
 
 auto Lexer::scanTokens() -> std::vector<Token> {
+  std::vector<Token> tokens = scanProgram();
+  for (const Token &token : tokens) {
+    if (token.type == TokenType::ERROR) {
+      throw std::runtime_error("Unexpected character");
+    }
+  }
+  return tokens;
+}
+
+auto Lexer::scanProgram() -> std::vector<Token> {
   std::vector<Token> tokens;
   while (!isAtEnd()) {
     tokens.push_back(scanToken());
   }
-  tokens.emplace_back(TokenType::END, "");
+  tokens.emplace_back(TokenType::END, std::string_view(), 0.0, line);
   return tokens;
 }
@@ -0,0 +1,39 @@
+#include "MappedFile.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+MappedFile::MappedFile(const std::string &path) {
+  const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd < 0) {
+    throw std::runtime_error("Cannot open '" + path + "'.");
+  }
+
+  struct stat info {};
+  if (::fstat(fd, &info) != 0) {
+    ::close(fd);
+    throw std::runtime_error("Cannot read '" + path + "'.");
+  }
+  length = static_cast<size_t>(info.st_size);
+
+  if (length > 0) {
+    void *mapping = ::mmap(nullptr, length, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE, fd, 0);
+    if (mapping == MAP_FAILED) {
+      ::close(fd);
+      throw std::runtime_error("Cannot map '" + path + "'.");
+    }
+    bytes = static_cast<std::byte *>(mapping);
+  }
+  // The mapping keeps the file referenced on its own.
+  ::close(fd);
+}
+
+MappedFile::~MappedFile() {
+  if (bytes != nullptr) {
+    ::munmap(bytes, length);
+  }
+}
+
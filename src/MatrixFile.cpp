@@ -0,0 +1,210 @@
+#include "MatrixFile.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <limits>
+#include <stdexcept>
+
+namespace {
+
+constexpr char MAGIC[4] = {'N', 'L', 'M', 'X'};
+
+static_assert(sizeof(size_t) == sizeof(uint64_t),
+              "CSR indices are stored as uint64_t");
+
+template <typename T> constexpr auto elementType() -> ElementType {
+  if constexpr (std::is_same_v<T, float>) {
+    return ElementType::FLOAT32;
+  } else if constexpr (std::is_same_v<T, int32_t>) {
+    return ElementType::INT32;
+  } else {
+    return ElementType::FLOAT64;
+  }
+}
+
+/**
+ * @brief Wrap the elements of a validated header as a Matrix<T>.
+ */
+template <typename T>
+auto mapElements(const std::shared_ptr<MappedFile> &file, size_t offset,
+                 const MatrixFileHeader &header,
+                 const std::runtime_error &invalid) -> Matrix<T> {
+  // Reject shapes whose byte size overflows or runs past the end of the file.
+  const uint64_t available = file->size() - offset;
+  if (header.dataOffset > available ||
+      (header.cols != 0 &&
+       header.rows > std::numeric_limits<uint64_t>::max() / header.cols) ||
+      header.rows * header.cols >
+          (available - header.dataOffset) / sizeof(T)) {
+    throw invalid;
+  }
+
+  const auto rows = static_cast<size_t>(header.rows);
+  const auto cols = static_cast<size_t>(header.cols);
+  if (rows * cols == 0) {
+    return Matrix<T>(rows, cols);
+  }
+  auto *values =
+      reinterpret_cast<T *>(file->data() + offset + header.dataOffset);
+  return {rows, cols, std::shared_ptr<T>(file, values)};
+}
+
+/**
+ * @brief Copy the CSR arrays of a validated header into a sparse matrix.
+ */
+auto mapSparse(const std::shared_ptr<MappedFile> &file, size_t offset,
+               const MatrixFileHeader &header,
+               const std::runtime_error &invalid) -> SparseMatrix<double> {
+  const uint64_t available = file->size() - offset;
+  if (header.dataOffset > available) {
+    throw invalid;
+  }
+  const uint64_t bytes = available - header.dataOffset;
+  if (header.rows >= bytes / sizeof(uint64_t) ||
+      header.nonZeros > (bytes - (header.rows + 1) * sizeof(uint64_t)) /
+                            (sizeof(uint64_t) + sizeof(double))) {
+    throw invalid;
+  }
+
+  const auto rows = static_cast<size_t>(header.rows);
+  const auto entries = static_cast<size_t>(header.nonZeros);
+  const std::byte *data = file->data() + offset + header.dataOffset;
+  std::vector<size_t> offsets(rows + 1);
+  std::vector<size_t> columns(entries);
+  std::vector<double> values(entries);
+  std::memcpy(offsets.data(), data, offsets.size() * sizeof(size_t));
+  data += offsets.size() * sizeof(size_t);
+  std::memcpy(columns.data(), data, entries * sizeof(size_t));
+  data += entries * sizeof(size_t);
+  std::memcpy(values.data(), data, entries * sizeof(double));
+  try {
+    return {rows, static_cast<size_t>(header.cols), std::move(offsets),
+            std::move(columns), std::move(values)};
+  } catch (const std::invalid_argument &) {
+    throw invalid;
+  }
+}
+
+auto writeSparse(const SparseMatrix<double> &matrix, std::ostream &out)
+    -> uint64_t {
+  MatrixFileHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = MATRIX_FILE_VERSION;
+  header.type = ElementType::FLOAT64;
+  header.layout = MatrixLayout::CSR;
+  header.rows = matrix.getRows();
+  header.cols = matrix.getCols();
+  header.dataOffset = sizeof(MatrixFileHeader);
+  header.nonZeros = matrix.nonZeros();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  auto write = [&out](const auto &array) {
+    out.write(reinterpret_cast<const char *>(array.data()),
+              static_cast<std::streamsize>(array.size() *
+                                           sizeof(array.front())));
+    return array.size() * sizeof(array.front());
+  };
+  return header.dataOffset + write(matrix.rowOffsets()) +
+         write(matrix.columnIndices()) + write(matrix.getValues());
+}
+
+template <typename T>
+auto writeElements(const Matrix<T> &matrix, std::ostream &out) -> uint64_t {
+  MatrixFileHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = MATRIX_FILE_VERSION;
+  header.type = elementType<T>();
+  header.rows = matrix.getRows();
+  header.cols = matrix.getCols();
+  header.dataOffset = sizeof(MatrixFileHeader);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  const auto rowBytes =
+      static_cast<std::streamsize>(matrix.getCols() * sizeof(T));
+  if (matrix.getStride() == matrix.getCols()) {
+    out.write(reinterpret_cast<const char *>(matrix.raw()),
+              rowBytes * static_cast<std::streamsize>(matrix.getRows()));
+  } else {
+    for (size_t i = 0; i < matrix.getRows(); ++i) {
+      out.write(reinterpret_cast<const char *>(matrix.rowPtr(i)), rowBytes);
+    }
+  }
+  return header.dataOffset + matrix.size() * sizeof(T);
+}
+
+} // namespace
+
+auto loadMatrix(const std::string &path) -> Value {
+  return mapMatrix(std::make_shared<MappedFile>(path), 0, path);
+}
+
+auto mapMatrix(const std::shared_ptr<MappedFile> &file, size_t offset,
+               const std::string &name) -> Value {
+  const std::runtime_error invalid("Invalid matrix file '" + name + "'.");
+  if (offset > file->size() ||
+      file->size() - offset < sizeof(MatrixFileHeader)) {
+    throw invalid;
+  }
+
+  MatrixFileHeader header{};
+  std::memcpy(&header, file->data() + offset, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version == 0 || header.version > MATRIX_FILE_VERSION ||
+      header.dataOffset % MATRIX_ALIGNMENT != 0 ||
+      header.dataOffset < sizeof(MatrixFileHeader)) {
+    throw invalid;
+  }
+  if (header.layout == MatrixLayout::CSR &&
+      header.type == ElementType::FLOAT64) {
+    return mapSparse(file, offset, header, invalid);
+  }
+  if (header.layout != MatrixLayout::DENSE) {
+    throw invalid;
+  }
+
+  switch (header.type) {
+  case ElementType::FLOAT64: {
+    Matrix<double> matrix =
+        mapElements<double>(file, offset, header, invalid);
+    if (matrix.size() == 1) {
+      return matrix(0, 0);
+    }
+    return matrix;
+  }
+  case ElementType::FLOAT32:
+    return mapElements<float>(file, offset, header, invalid);
+  case ElementType::INT32:
+    return mapElements<int32_t>(file, offset, header, invalid);
+  }
+  throw invalid;
+}
+
+auto writeMatrix(const Value &value, std::ostream &out) -> uint64_t {
+  if (value.isSparse()) {
+    return writeSparse(value.sparse(), out);
+  }
+  switch (value.dtype()) {
+  case DType::FLOAT32:
+    return writeElements(value.get<Matrix<float>>(), out);
+  case DType::INT32:
+    return writeElements(value.get<Matrix<int32_t>>(), out);
+  case DType::FLOAT64:
+    break;
+  }
+  return writeElements(value.toDense(), out);
+}
+
+void saveMatrix(const Value &value, const std::string &path) {
+  // Matrices loaded from path keep mapping the old file after the rename.
+  const std::string temporary = path + ".tmp";
+  std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Cannot open '" + temporary + "'.");
+  }
+  writeMatrix(value, out);
+  out.close();
+  if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot write '" + path + "'.");
+  }
+}
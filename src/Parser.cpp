@@ -1,121 +1,236 @@
 #include "Parser.h"
+#include <algorithm>
 #include <stdexcept>
+#include <type_traits>
 
-auto Parser::parse() -> std::shared_ptr<Expression> { return expression(); }
+namespace {
 
-auto Parser::expression() -> std::shared_ptr<Expression> {
-  return assignment();
+// Freeing a tree is then a matter of freeing the arena's blocks.
+static_assert(std::is_trivially_destructible_v<BinaryExpr> &&
+                  std::is_trivially_destructible_v<LiteralExpr> &&
+                  std::is_trivially_destructible_v<NumberExpr> &&
+                  std::is_trivially_destructible_v<VariableExpr> &&
+                  std::is_trivially_destructible_v<AssignExpr> &&
+                  std::is_trivially_destructible_v<StringExpr> &&
+                  std::is_trivially_destructible_v<CallExpr>,
+              "Syntax tree nodes must not need destructors");
+
+/**
+ * @brief The binary operator applied by a compound assignment token.
+ */
+auto compoundOperator(TokenType compound) -> TokenType {
+  switch (compound) {
+  case TokenType::PLUS_ASSIGN:
+    return TokenType::PLUS;
+  case TokenType::MINUS_ASSIGN:
+    return TokenType::MINUS;
+  default:
+    return TokenType::MULTIPLY;
+  }
 }
 
-auto Parser::assignment() -> std::shared_ptr<Expression> {
-  auto expr = term();
+} // namespace
+
+auto Parser::parse() -> std::shared_ptr<Expression> {
+  auto owner = std::make_shared<Arena>();
+  arena = owner.get();
+  Expression *root = expression();
+  arena = nullptr;
+  return {std::move(owner), root};
+}
+
+auto Parser::parseProgram() -> std::vector<Statement> {
+  auto owner = std::make_shared<Arena>();
+  arena = owner.get();
+  std::vector<Statement> statements;
+
+  while (!isAtEnd()) {
+    if (match(TokenType::EOL) || match(TokenType::SEMICOLON)) {
+      continue;
+    }
+    const size_t line = peek().line;
+    try {
+      Expression *expr = expression();
+      const bool printResult = !match(TokenType::SEMICOLON);
+      if (printResult && !isAtEnd()) {
+        consume(TokenType::EOL, "Expect end of statement.");
+      }
+      statements.push_back({{owner, expr}, line, printResult, {}});
+    } catch (const std::runtime_error &e) {
+      statements.push_back({nullptr, line, false, e.what()});
+      synchronize();
+    }
+  }
+
+  arena = nullptr;
+  return statements;
+}
+
+auto Parser::expression() -> Expression * { return assignment(); }
+
+auto Parser::assignment() -> Expression * {
+  auto *expr = term();
 
   if (match(TokenType::ASSIGN)) {
-    Token equals = previous();
-    auto value = assignment();
+    auto *value = assignment();
 
-    if (auto *varExpr = dynamic_cast<VariableExpr *>(expr.get())) {
-      Token name = varExpr->name;
-      return std::make_shared<AssignExpr>(name, value);
+    if (expr->kind == ExprKind::VARIABLE) {
+      auto *varExpr = static_cast<VariableExpr *>(expr);
+      return arena->create<AssignExpr>(varExpr->name, value);
     }
 
     throw std::runtime_error("Invalid assignment target.");
   }
 
+  // X op= Y is sugar for X = X op Y; the compiler evaluates element-wise
+  // updates in place on X's buffer.
+  if (match(TokenType::PLUS_ASSIGN) || match(TokenType::MINUS_ASSIGN) ||
+      match(TokenType::MULTIPLY_ASSIGN)) {
+    const TokenType compound = previous().type;
+    auto *value = assignment();
+
+    if (expr->kind != ExprKind::VARIABLE) {
+      throw std::runtime_error("Invalid assignment target.");
+    }
+
+    auto *varExpr = static_cast<VariableExpr *>(expr);
+    return arena->create<AssignExpr>(
+        varExpr->name,
+        arena->create<BinaryExpr>(expr, compoundOperator(compound), value));
+  }
+
   return expr;
 }
 
-auto Parser::term() -> std::shared_ptr<Expression> {
-  auto expr = factor();
+auto Parser::term() -> Expression * {
+  auto *expr = factor();
 
   while (match(TokenType::PLUS) || match(TokenType::MINUS)) {
-    Token op = previous();
-    auto right = factor();
-    expr = std::make_shared<BinaryExpr>(expr, op, right);
+    const TokenType op = previous().type;
+    auto *right = factor();
+    expr = arena->create<BinaryExpr>(expr, op, right);
   }
 
   return expr;
 }
 
-auto Parser::factor() -> std::shared_ptr<Expression> {
-  auto expr = primary();
+auto Parser::factor() -> Expression * {
+  auto *expr = primary();
 
   while (match(TokenType::MULTIPLY)) {
-    Token op = previous();
-    auto right = primary();
-    expr = std::make_shared<BinaryExpr>(expr, op, right);
+    const TokenType op = previous().type;
+    auto *right = primary();
+    expr = arena->create<BinaryExpr>(expr, op, right);
   }
 
   return expr;
 }
 
-auto Parser::primary() -> std::shared_ptr<Expression> {
+auto Parser::primary() -> Expression * {
   if (match(TokenType::NUMBER)) {
-    Matrix<double> scalar(1, 1);
-    scalar(0, 0) = std::stod(previous().lexeme);
-    return std::make_shared<LiteralExpr>(scalar);
+    return arena->create<NumberExpr>(previous().number);
   }
 
   if (match(TokenType::IDENTIFIER)) {
-    return std::make_shared<VariableExpr>(previous());
+    const std::string_view name = arena->copy(previous().lexeme);
+    if (match(TokenType::LPAREN)) {
+      return call(name);
+    }
+    return arena->create<VariableExpr>(name);
+  }
+
+  if (match(TokenType::STRING)) {
+    return arena->create<StringExpr>(arena->copy(previous().lexeme));
   }
 
   if (match(TokenType::LBRACKET)) {
     auto matrix = parseMatrix();
     consume(TokenType::RBRACKET, "Expect ']' after matrix.");
-    return std::make_shared<LiteralExpr>(matrix);
+    return arena->create<LiteralExpr>(
+        *arena->create<Matrix<double>>(std::move(matrix)));
   }
 
   if (match(TokenType::LPAREN)) {
-    auto expr = expression();
+    auto *expr = expression();
     consume(TokenType::RPAREN, "Expect ')' after expression.");
     return expr;
   }
 
+  if (check(TokenType::ERROR)) {
+    throw std::runtime_error("Unexpected character '" +
+                             std::string(peek().lexeme) + "'.");
+  }
+
   throw std::runtime_error("Expect expression.");
 }
 
+auto Parser::call(std::string_view name) -> Expression * {
+  std::vector<Expression *> arguments;
+  if (!check(TokenType::RPAREN)) {
+    do {
+      arguments.push_back(expression());
+    } while (match(TokenType::COMMA));
+  }
+  consume(TokenType::RPAREN, "Expect ')' after arguments.");
+
+  auto **array = static_cast<Expression **>(arena->allocate(
+      arguments.size() * sizeof(Expression *), alignof(Expression *)));
+  std::copy(arguments.begin(), arguments.end(), array);
+  return arena->create<CallExpr>(name, array, arguments.size());
+}
+
 auto Parser::parseMatrix() -> Matrix<double> {
-  std::vector<std::vector<double>> rows;
-  std::vector<double> currentRow;
+  // Size the buffer from the tokens up to the closing bracket, so the values
+  // are written once, straight into the storage the matrix adopts.
+  size_t count = 0;
+  for (size_t i = current; i < tokens.size(); ++i) {
+    if (tokens[i].type == TokenType::RBRACKET) {
+      break;
+    }
+    count += tokens[i].type == TokenType::NUMBER ? 1 : 0;
+  }
+  Matrix<double>::Storage values;
+  values.reserve(count);
+
+  size_t rowCount = 0;
+  size_t cols = 0;
+  size_t currentCols = 0;
+
+  auto endRow = [&]() {
+    if (currentCols == 0) {
+      return;
+    }
+    if (rowCount == 0) {
+      cols = currentCols;
+    } else if (currentCols != cols) {
+      throw std::runtime_error("Inconsistent matrix dimensions.");
+    }
+    ++rowCount;
+    currentCols = 0;
+  };
 
   while (!check(TokenType::RBRACKET)) {
     if (match(TokenType::NUMBER)) {
-      currentRow.push_back(std::stod(previous().lexeme));
+      if (rowCount > 0 && currentCols == cols) {
+        throw std::runtime_error("Inconsistent matrix dimensions.");
+      }
+      values.push_back(previous().number);
+      ++currentCols;
     } else if (match(TokenType::COMMA)) {
       continue;
-    } else if (match(TokenType::SEMICOLON)) {
-      if (!currentRow.empty()) {
-        rows.push_back(currentRow);
-        currentRow.clear();
-      }
+    } else if (match(TokenType::SEMICOLON) || match(TokenType::EOL)) {
+      endRow();
     } else {
       throw std::runtime_error("Invalid matrix format.");
     }
   }
+  endRow();
 
-  if (!currentRow.empty()) {
-    rows.push_back(currentRow);
-  }
-
-  if (rows.empty()) {
+  if (rowCount == 0) {
     throw std::runtime_error("Empty matrix.");
   }
 
-  size_t cols = rows[0].size();
-  for (const auto &row : rows) {
-    if (row.size() != cols) {
-      throw std::runtime_error("Inconsistent matrix dimensions.");
-    }
-  }
-
-  Matrix<double> result(rows.size(), cols);
-  for (size_t i = 0; i < rows.size(); ++i) {
-    for (size_t j = 0; j < cols; ++j) {
-      result(i, j) = rows[i][j];
-    }
-  }
-  return result;
+  return {rowCount, cols, std::move(values)};
 }
 
 auto Parser::match(TokenType type) -> bool {
@@ -153,3 +268,9 @@ void Parser::consume(TokenType type, const std::string &message) {
   }
   throw std::runtime_error(message);
 }
+
+void Parser::synchronize() {
+  while (!isAtEnd() && !match(TokenType::EOL)) {
+    advance();
+  }
+}
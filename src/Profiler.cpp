@@ -0,0 +1,81 @@
+#include "Profiler.h"
+#include <iomanip>
+#include <ostream>
+
+namespace {
+
+constexpr std::array<const char *, Profiler::PHASE_COUNT> PHASE_NAMES = {
+    "lex", "parse", "compile", "eval", "print"};
+
+constexpr std::array<const char *, Profiler::OPERATION_COUNT>
+    OPERATION_NAMES = {"load", "store", "elementwise", "multiply", "call"};
+
+template <size_t N>
+void printRows(std::ostream &out, const char *title,
+               const std::array<const char *, N> &names,
+               const std::array<Profiler::Counters, N> &counters) {
+  out << std::left << std::setw(14) << title << std::right << std::setw(10)
+      << "calls" << std::setw(12) << "time (ms)" << std::setw(14)
+      << "allocated" << std::setw(12) << "GFLOP/s" << '\n';
+  for (size_t i = 0; i < N; ++i) {
+    const Profiler::Counters &c = counters[i];
+    const double seconds = static_cast<double>(c.nanoseconds) * 1e-9;
+    const double gflops =
+        seconds > 0 ? static_cast<double>(c.flops) * 1e-9 / seconds : 0.0;
+    out << std::left << std::setw(14) << names[i] << std::right
+        << std::setw(10) << c.calls << std::setw(12) << std::fixed
+        << std::setprecision(3) << seconds * 1e3 << std::setw(14) << c.bytes
+        << std::setw(12) << std::setprecision(3) << gflops << '\n';
+  }
+  out << std::defaultfloat;
+}
+
+template <size_t N>
+void writeObject(std::ostream &out, const std::array<const char *, N> &names,
+                 const std::array<Profiler::Counters, N> &counters) {
+  out << '{';
+  for (size_t i = 0; i < N; ++i) {
+    const Profiler::Counters &c = counters[i];
+    out << (i > 0 ? ", " : "") << '"' << names[i] << "\": {\"calls\": "
+        << c.calls << ", \"nanoseconds\": " << c.nanoseconds
+        << ", \"bytes\": " << c.bytes << ", \"flops\": " << c.flops << '}';
+  }
+  out << '}';
+}
+
+} // namespace
+
+Profiler::Scope::Scope(Counters *counters) : target(counters) {
+  if (target != nullptr) {
+    startBytes = instance().allocated.load(std::memory_order_relaxed);
+    start = std::chrono::steady_clock::now();
+  }
+}
+
+void Profiler::Scope::finish() {
+  const auto elapsed = std::chrono::steady_clock::now() - start;
+  ++target->calls;
+  target->nanoseconds += static_cast<uint64_t>(
+      std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count());
+  target->bytes +=
+      instance().allocated.load(std::memory_order_relaxed) - startBytes;
+  target->flops += flops;
+}
+
+void Profiler::reset() {
+  phases.fill({});
+  operations.fill({});
+}
+
+void Profiler::report(std::ostream &out) const {
+  printRows(out, "phase", PHASE_NAMES, phases);
+  printRows(out, "operation", OPERATION_NAMES, operations);
+}
+
+void Profiler::writeJson(std::ostream &out) const {
+  out << "{\"phases\": ";
+  writeObject(out, PHASE_NAMES, phases);
+  out << ", \"operations\": ";
+  writeObject(out, OPERATION_NAMES, operations);
+  out << "}\n";
+}
@@ -0,0 +1,103 @@
+#include "Runner.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include "Profiler.h"
+#include <algorithm>
+#include <exception>
+#include <string>
+
+auto Runner::run(std::istream &in) -> size_t {
+  std::string pending;
+  size_t line = 1;
+  size_t failures = 0;
+  // Scan state over pending: bytes examined so far, bracket depth and
+  // whether a string literal is open there, and the end of the last line
+  // that closes outside any matrix literal.
+  size_t scanned = 0;
+  int depth = 0;
+  bool quoted = false;
+  size_t complete = 0;
+
+  while (in) {
+    const size_t offset = pending.size();
+    pending.resize(offset + BATCH_BYTES);
+    in.read(&pending[offset], BATCH_BYTES);
+    pending.resize(offset + static_cast<size_t>(in.gcount()));
+
+    for (; scanned < pending.size(); ++scanned) {
+      // Strings end at the closing quote or the end of the line.
+      if (quoted && pending[scanned] != '"' && pending[scanned] != '\n') {
+        continue;
+      }
+      switch (pending[scanned]) {
+      case '"':
+        quoted = !quoted;
+        break;
+      case '[':
+        ++depth;
+        break;
+      case ']':
+        depth = std::max(depth - 1, 0);
+        break;
+      case '\n':
+        quoted = false;
+        complete = depth == 0 ? scanned + 1 : complete;
+        break;
+      default:
+        break;
+      }
+    }
+    if (complete == 0) {
+      continue;
+    }
+
+    const std::string_view batch(pending.data(), complete);
+    failures += run(batch, line);
+    line += static_cast<size_t>(std::count(batch.begin(), batch.end(), '\n'));
+    pending.erase(0, complete);
+    scanned -= complete;
+    complete = 0;
+  }
+  if (!pending.empty()) {
+    failures += run(pending, line);
+  }
+  return failures;
+}
+
+auto Runner::run(std::string_view source, size_t firstLine) -> size_t {
+  std::vector<Token> tokens;
+  {
+    Profiler::Scope scope(Profiler::Phase::LEX);
+    tokens = Lexer(source, firstLine).scanProgram();
+  }
+  std::vector<Statement> statements;
+  {
+    Profiler::Scope scope(Profiler::Phase::PARSE);
+    statements = Parser(std::move(tokens)).parseProgram();
+  }
+  size_t failures = 0;
+
+  for (const Statement &statement : statements) {
+    if (!statement.expression) {
+      report(statement.line, statement.error.c_str());
+      ++failures;
+      continue;
+    }
+    try {
+      Value result =
+          interpreter.interpret(statement.expression, statement.printResult);
+      if (statement.printResult) {
+        Profiler::Scope scope(Profiler::Phase::PRINT);
+        out << result << '\n';
+      }
+    } catch (const std::exception &e) {
+      report(statement.line, e.what());
+      ++failures;
+    }
+  }
+  return failures;
+}
+
+void Runner::report(size_t line, const char *message) {
+  err << "Error on line " << line << ": " << message << '\n';
+}
@@ -0,0 +1,362 @@
+#include "Server.h"
+#include "Runner.h"
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <deque>
+#include <fcntl.h>
+#include <mutex>
+#include <poll.h>
+#include <sstream>
+#include <stdexcept>
+#include <string_view>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+/**
+ * @brief Bytes read from a socket at once.
+ */
+constexpr size_t READ_BYTES = 64 * 1024;
+
+/**
+ * @brief Write all of data, retrying after partial writes.
+ *
+ * @return bool False if the peer is gone or stopped reading for longer
+ * than the socket's send timeout.
+ */
+auto sendAll(int fd, const std::string &data) -> bool {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    const ssize_t n =
+        ::send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n < 0 && errno == EINTR) {
+      continue;
+    }
+    if (n <= 0) {
+      return false;
+    }
+    sent += static_cast<size_t>(n);
+  }
+  return true;
+}
+
+auto reply(bool ok, const std::string &payload) -> std::string {
+  return std::string(ok ? "OK " : "ERR ") + std::to_string(payload.size()) +
+         '\n' + payload;
+}
+
+void closeIfOpen(int &fd) {
+  if (fd >= 0) {
+    ::close(fd);
+    fd = -1;
+  }
+}
+
+} // namespace
+
+/**
+ * @brief A connection and its interpreter.
+ *
+ * input is only touched by the polling thread. pending and running are
+ * shared with the workers; running is set while a drain() task is queued or
+ * executing, so at most one request of the session runs at a time.
+ */
+struct Server::Session {
+  struct Request {
+    std::string source;
+    std::chrono::steady_clock::time_point deadline;
+    std::string error; // If not empty, reply with it and close the session
+  };
+
+  explicit Session(int fd) : fd(fd) {}
+
+  Session(const Session &) = delete;
+  auto operator=(const Session &) -> Session & = delete;
+
+  ~Session() { ::close(fd); }
+
+  const int fd;
+  Interpreter interpreter;
+  std::string input;   // Bytes read but not queued yet
+  size_t lineBytes = 0; // Length of the unterminated line at its end
+  std::mutex mutex;
+  std::deque<Request> pending;
+  bool running = false;
+};
+
+Server::Server(std::string path, ServerOptions options)
+    : path(std::move(path)), options(std::move(options)) {
+  sockaddr_un address{};
+  address.sun_family = AF_UNIX;
+  if (this->path.empty() || this->path.size() >= sizeof(address.sun_path)) {
+    throw std::runtime_error("Invalid socket path '" + this->path + "'.");
+  }
+  std::memcpy(address.sun_path, this->path.c_str(), this->path.size());
+
+  int pipeFds[2] = {-1, -1};
+  if (::pipe2(pipeFds, O_CLOEXEC | O_NONBLOCK) != 0) {
+    throw std::runtime_error("Cannot create a pipe.");
+  }
+  wakeRead = pipeFds[0];
+  wakeWrite = pipeFds[1];
+
+  // Replace a socket left behind by a previous server, but nothing else.
+  struct stat info {};
+  if (::stat(this->path.c_str(), &info) == 0 && S_ISSOCK(info.st_mode)) {
+    ::unlink(this->path.c_str());
+  }
+  listener = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC | SOCK_NONBLOCK, 0);
+  if (listener < 0 ||
+      ::bind(listener, reinterpret_cast<const sockaddr *>(&address),
+             sizeof(address)) != 0 ||
+      ::listen(listener, SOMAXCONN) != 0) {
+    closeIfOpen(listener);
+    closeIfOpen(wakeRead);
+    closeIfOpen(wakeWrite);
+    throw std::runtime_error("Cannot listen on '" + this->path + "'.");
+  }
+}
+
+Server::~Server() {
+  closeIfOpen(listener);
+  ::unlink(path.c_str());
+  closeIfOpen(wakeRead);
+  closeIfOpen(wakeWrite);
+}
+
+void Server::run() {
+  {
+    // Requests resubmit themselves to the pool, so it must stay reachable
+    // while its destructor runs the ones still queued.
+    ThreadPool workers(options.workers);
+    pool = &workers;
+    serve();
+    connections.clear();
+    sessions = 0;
+  }
+  pool = nullptr;
+}
+
+void Server::serve() {
+  std::vector<pollfd> fds;
+  std::vector<std::shared_ptr<Session>> polled;
+  while (!stopping) {
+    fds.clear();
+    polled.clear();
+    fds.push_back({listener, POLLIN, 0});
+    fds.push_back({wakeRead, POLLIN, 0});
+    for (const auto &connection : connections) {
+      const std::shared_ptr<Session> &session = connection.second;
+      // Queue lines held back earlier, then read only if there is room.
+      dispatch(session);
+      std::lock_guard<std::mutex> lock(session->mutex);
+      if (session->pending.size() < options.maxPending) {
+        fds.push_back({session->fd, POLLIN, 0});
+        polled.push_back(session);
+      }
+    }
+
+    if (::poll(fds.data(), fds.size(), -1) < 0) {
+      if (errno == EINTR) {
+        continue;
+      }
+      throw std::runtime_error("Cannot poll sockets.");
+    }
+    if (fds[1].revents != 0) {
+      char bytes[64];
+      while (::read(wakeRead, bytes, sizeof(bytes)) > 0) {
+      }
+    }
+    if (fds[0].revents != 0) {
+      accept();
+    }
+    for (size_t i = 2; i < fds.size(); ++i) {
+      if (fds[i].revents != 0) {
+        read(polled[i - 2]);
+      }
+    }
+  }
+}
+
+void Server::stop() {
+  stopping = true;
+  wake();
+}
+
+void Server::wake() {
+  const char byte = 0;
+  // A full pipe already guarantees a wake-up.
+  [[maybe_unused]] const ssize_t written = ::write(wakeWrite, &byte, 1);
+}
+
+void Server::accept() {
+  const int fd = ::accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+  if (fd < 0) {
+    return;
+  }
+  if (connections.size() >= options.maxSessions) {
+    sendAll(fd, reply(false, "Too many sessions.\n"));
+    ::close(fd);
+    return;
+  }
+  // A client that stops reading its replies gives up its worker after the
+  // request timeout.
+  if (options.timeout.count() > 0) {
+    const auto seconds =
+        std::chrono::duration_cast<std::chrono::seconds>(options.timeout);
+    const auto micros = std::chrono::duration_cast<std::chrono::microseconds>(
+        options.timeout - seconds);
+    timeval limit{static_cast<time_t>(seconds.count()),
+                  static_cast<suseconds_t>(std::max<int64_t>(
+                      micros.count(), seconds.count() == 0 ? 1 : 0))};
+    ::setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &limit, sizeof(limit));
+  }
+
+  auto session = std::make_shared<Session>(fd);
+  if (!options.workspace.empty()) {
+    try {
+      session->interpreter.loadWorkspace(options.workspace);
+    } catch (const std::exception &e) {
+      sendAll(fd, reply(false, std::string(e.what()) + '\n'));
+      return;
+    }
+  }
+  connections.emplace(fd, std::move(session));
+  ++sessions;
+}
+
+void Server::read(const std::shared_ptr<Session> &session) {
+  char buffer[READ_BYTES];
+  const ssize_t n = ::read(session->fd, buffer, sizeof(buffer));
+  if (n < 0 && (errno == EINTR || errno == EAGAIN)) {
+    return;
+  }
+  if (n > 0) {
+    const std::string_view received(buffer, static_cast<size_t>(n));
+    const size_t lineEnd = received.rfind('\n');
+    session->lineBytes = lineEnd == std::string_view::npos
+                             ? session->lineBytes + received.size()
+                             : received.size() - lineEnd - 1;
+    session->input.append(received);
+    dispatch(session);
+    // Complete lines are bounded by back-pressure, the line being received
+    // by the limit.
+    if (session->lineBytes > options.maxRequestBytes) {
+      session->input.resize(session->input.size() - session->lineBytes);
+      connections.erase(session->fd);
+      --sessions;
+      dispatch(session, true);
+      reject(session, "Request longer than " +
+                          std::to_string(options.maxRequestBytes) +
+                          " bytes.\n");
+    }
+    return;
+  }
+
+  // The client is gone or has finished sending: answer everything it sent,
+  // including an unterminated last line, and close once that is done.
+  connections.erase(session->fd);
+  --sessions;
+  if (n == 0) {
+    if (!session->input.empty() && session->input.back() != '\n') {
+      session->input += '\n';
+    }
+    dispatch(session, true);
+  }
+}
+
+void Server::dispatch(const std::shared_ptr<Session> &session, bool all) {
+  const auto now = std::chrono::steady_clock::now();
+  const auto deadline = options.timeout.count() > 0
+                            ? now + options.timeout
+                            : Interpreter::NO_DEADLINE;
+  size_t start = 0;
+  bool submit = false;
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    while (all || session->pending.size() < options.maxPending) {
+      const size_t end = session->input.find('\n', start);
+      if (end == std::string::npos) {
+        break;
+      }
+      session->pending.push_back(
+          {session->input.substr(start, end + 1 - start), deadline, {}});
+      start = end + 1;
+    }
+    if (!session->running && !session->pending.empty()) {
+      session->running = true;
+      submit = true;
+    }
+  }
+  session->input.erase(0, start);
+  if (submit) {
+    pool->submit([this, session]() { drain(session); });
+  }
+}
+
+void Server::reject(const std::shared_ptr<Session> &session,
+                    std::string error) {
+  bool submit = false;
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    session->pending.push_back(
+        {std::string(), Interpreter::NO_DEADLINE, std::move(error)});
+    submit = !session->running;
+    session->running = true;
+  }
+  if (submit) {
+    pool->submit([this, session]() { drain(session); });
+  }
+}
+
+void Server::drain(const std::shared_ptr<Session> &session) {
+  Session::Request request;
+  bool resume = false;
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    resume = session->pending.size() == options.maxPending;
+    request = std::move(session->pending.front());
+    session->pending.pop_front();
+  }
+  if (resume) {
+    wake();
+  }
+
+  bool close = !request.error.empty();
+  if (close) {
+    sendAll(session->fd, reply(false, request.error));
+  } else {
+    // An expired request still goes through the interpreter, which reports
+    // the timeout like any other error.
+    std::ostringstream out;
+    std::ostringstream err;
+    session->interpreter.setDeadline(request.deadline);
+    const size_t failures =
+        Runner(session->interpreter, out, err).run(request.source);
+    session->interpreter.setDeadline(Interpreter::NO_DEADLINE);
+    close = !sendAll(session->fd, failures == 0 ? reply(true, out.str())
+                                                : reply(false, err.str()));
+  }
+
+  bool more = false;
+  {
+    std::lock_guard<std::mutex> lock(session->mutex);
+    if (close) {
+      // Nobody is listening, or the session was rejected: drop the rest and
+      // let the poller see a hangup.
+      session->pending.clear();
+      ::shutdown(session->fd, SHUT_RDWR);
+    }
+    more = !session->pending.empty();
+    session->running = more;
+  }
+  // Requeue rather than loop, so that busy sessions take turns.
+  if (more) {
+    pool->submit([this, session]() { drain(session); });
+  }
+}
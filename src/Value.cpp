@@ -0,0 +1,208 @@
+#include "Value.h"
+#include <cmath>
+#include <iomanip>
+#include <limits>
+#include <type_traits>
+
+namespace {
+
+/**
+ * @brief Call f with a value of the element type of type.
+ */
+template <typename F> auto dispatch(DType type, F f) -> Value {
+  switch (type) {
+  case DType::INT32:
+    return f(int32_t());
+  case DType::FLOAT32:
+    return f(float());
+  case DType::FLOAT64:
+    break;
+  }
+  return f(double());
+}
+
+/**
+ * @brief Element type of a matrix of type combined with the scalar s.
+ */
+auto withScalar(DType type, double s) -> DType {
+  return type == DType::INT32 && !fitsInt32(s) ? DType::FLOAT64 : type;
+}
+
+/**
+ * @brief m + s, m - s or, when reversed, s - m, with one broadcast kernel
+ * per pass.
+ */
+template <typename T>
+auto broadcastAdd(const Matrix<T> &m, T s, bool subtract, bool reversed)
+    -> Matrix<T> {
+  Matrix<T> result = Matrix<T>::uninitialized(m.getRows(), m.getCols());
+  if (reversed && subtract) {
+    simd::broadcast(simd::Op::MUL, m.raw(), T(-1), result.raw(), m.size());
+    simd::broadcast(simd::Op::ADD, result.raw(), s, result.raw(), m.size());
+  } else {
+    simd::broadcast(subtract ? simd::Op::SUB : simd::Op::ADD, m.raw(), s,
+                    result.raw(), m.size());
+  }
+  return result;
+}
+
+} // namespace
+
+auto promote(DType a, DType b) -> DType { return a == b ? a : DType::FLOAT64; }
+
+auto fitsInt32(double s) -> bool {
+  return std::floor(s) == s &&
+         s >= static_cast<double>(std::numeric_limits<int32_t>::min()) &&
+         s <= static_cast<double>(std::numeric_limits<int32_t>::max());
+}
+
+auto Value::compact(SparseMatrix<double> matrix) -> Value {
+  if (matrix.storageBytes() >= matrix.size() * sizeof(double)) {
+    return matrix.toDense();
+  }
+  return matrix;
+}
+
+auto Value::dtype() const -> DType {
+  if (holds<Matrix<float>>()) {
+    return DType::FLOAT32;
+  }
+  return holds<Matrix<int32_t>>() ? DType::INT32 : DType::FLOAT64;
+}
+
+auto Value::convert(DType type) const -> Value {
+  switch (type) {
+  case DType::INT32:
+    return as<int32_t>();
+  case DType::FLOAT32:
+    return as<float>();
+  case DType::FLOAT64:
+    break;
+  }
+  if (isScalar() || isSparse()) {
+    return *this;
+  }
+  return as<double>();
+}
+
+auto Value::getRows() const -> size_t {
+  return std::visit(
+      [](const auto &value) -> size_t {
+        if constexpr (std::is_same_v<std::decay_t<decltype(value)>, double>) {
+          return 1;
+        } else {
+          return value.getRows();
+        }
+      },
+      data);
+}
+
+auto Value::getCols() const -> size_t {
+  return std::visit(
+      [](const auto &value) -> size_t {
+        if constexpr (std::is_same_v<std::decay_t<decltype(value)>, double>) {
+          return 1;
+        } else {
+          return value.getCols();
+        }
+      },
+      data);
+}
+
+auto Value::operator()(size_t row, size_t col) const -> double {
+  return std::visit(
+      [row, col](const auto &value) -> double {
+        if constexpr (std::is_same_v<std::decay_t<decltype(value)>, double>) {
+          return value;
+        } else {
+          return static_cast<double>(value(row, col));
+        }
+      },
+      data);
+}
+
+auto operator<<(std::ostream &os, const Value &value) -> std::ostream & {
+  if (value.isScalar()) {
+    return os << std::setw(8) << value.scalar() << '\n';
+  }
+  std::visit(
+      [&os](const auto &matrix) {
+        if constexpr (!std::is_same_v<std::decay_t<decltype(matrix)>,
+                                      double>) {
+          os << matrix;
+        }
+      },
+      value.data);
+  return os;
+}
+
+auto multiply(const Value &a, const Value &b, gemm::Algorithm algorithm)
+    -> Value {
+  if (a.isScalar() && b.isScalar()) {
+    return a.scalar() * b.scalar();
+  }
+  if (a.isDense() && b.isDense()) {
+    return a.dense().multiply(b.dense(), algorithm);
+  }
+  if (a.size() == 1) {
+    return scale(b, a(0, 0));
+  }
+  if (b.size() == 1) {
+    return scale(a, b(0, 0));
+  }
+  if (a.isSparse() && b.isSparse()) {
+    return Value::compact(a.sparse() * b.sparse());
+  }
+  if (a.isSparse()) {
+    return a.sparse() * b.toDense();
+  }
+  if (b.isSparse()) {
+    return a.toDense() * b.sparse();
+  }
+  return dispatch(promote(a.dtype(), b.dtype()), [&](auto t) -> Value {
+    using T = decltype(t);
+    return a.as<T>().multiply(b.as<T>(), algorithm);
+  });
+}
+
+auto add(const Value &a, const Value &b, bool subtract) -> Value {
+  if (a.isScalar() && b.isScalar()) {
+    return subtract ? a.scalar() - b.scalar() : a.scalar() + b.scalar();
+  }
+  // Broadcast a 1x1 operand in the type of the matrix it meets.
+  const bool reversed = a.size() == 1 && b.size() != 1;
+  if (reversed || (b.size() == 1 && a.size() != 1)) {
+    const Value &m = reversed ? b : a;
+    const double s = reversed ? a(0, 0) : b(0, 0);
+    return dispatch(withScalar(m.dtype(), s), [&](auto t) -> Value {
+      using T = decltype(t);
+      return broadcastAdd(m.as<T>(), static_cast<T>(s), subtract, reversed);
+    });
+  }
+  if (a.isSparse() && b.isSparse()) {
+    return Value::compact(subtract ? a.sparse() - b.sparse()
+                                   : a.sparse() + b.sparse());
+  }
+  return dispatch(promote(a.dtype(), b.dtype()), [&](auto t) -> Value {
+    using T = decltype(t);
+    const Matrix<T> left = a.as<T>();
+    const Matrix<T> right = b.as<T>();
+    if (subtract) {
+      return Matrix<T>(left - right);
+    }
+    return Matrix<T>(left + right);
+  });
+}
+
+auto scale(const Value &a, double factor) -> Value {
+  if (a.isScalar()) {
+    return a.scalar() * factor;
+  }
+  if (a.isSparse()) {
+    return a.sparse() * factor;
+  }
+  return dispatch(withScalar(a.dtype(), factor), [&](auto t) -> Value {
+    using T = decltype(t);
+    return Matrix<T>(a.as<T>() * static_cast<T>(factor));
+  });
+}
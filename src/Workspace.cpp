@@ -0,0 +1,102 @@
+#include "Workspace.h"
+#include "MatrixFile.h"
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace {
+
+constexpr char MAGIC[4] = {'N', 'L', 'W', 'S'};
+
+/**
+ * @brief Pad the stream with zeros up to a multiple of MATRIX_ALIGNMENT.
+ */
+auto align(std::ostream &out, uint64_t position) -> uint64_t {
+  static constexpr char ZEROS[MATRIX_ALIGNMENT] = {};
+  const uint64_t padding =
+      (MATRIX_ALIGNMENT - position % MATRIX_ALIGNMENT) % MATRIX_ALIGNMENT;
+  out.write(ZEROS, static_cast<std::streamsize>(padding));
+  return position + padding;
+}
+
+} // namespace
+
+void saveWorkspace(
+    const std::string &path,
+    const std::vector<std::pair<std::string, const Value *>> &variables) {
+  const std::string temporary = path + ".tmp";
+  std::ofstream out(temporary, std::ios::binary | std::ios::trunc);
+  if (!out) {
+    throw std::runtime_error("Cannot open '" + temporary + "'.");
+  }
+
+  WorkspaceHeader header{};
+  std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+  header.version = WORKSPACE_VERSION;
+  header.count = variables.size();
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  std::vector<uint64_t> offsets;
+  uint64_t position = sizeof(header);
+  for (const auto &variable : variables) {
+    offsets.push_back(position);
+    position = align(out, position + writeMatrix(*variable.second, out));
+  }
+
+  header.indexOffset = position;
+  for (size_t i = 0; i < variables.size(); ++i) {
+    const std::string &name = variables[i].first;
+    const auto length = static_cast<uint32_t>(name.size());
+    out.write(reinterpret_cast<const char *>(&offsets[i]), sizeof(uint64_t));
+    out.write(reinterpret_cast<const char *>(&length), sizeof(length));
+    out.write(name.data(), static_cast<std::streamsize>(name.size()));
+  }
+  out.seekp(0);
+  out.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+  out.close();
+  if (!out || std::rename(temporary.c_str(), path.c_str()) != 0) {
+    std::remove(temporary.c_str());
+    throw std::runtime_error("Cannot write '" + path + "'.");
+  }
+}
+
+auto openWorkspace(const std::string &path)
+    -> std::vector<std::pair<std::string, StoredVariable>> {
+  auto file = std::make_shared<MappedFile>(path);
+  const std::runtime_error invalid("Invalid workspace file '" + path + "'.");
+  const auto *bytes = reinterpret_cast<const char *>(file->data());
+  const size_t size = file->size();
+
+  WorkspaceHeader header{};
+  if (size < sizeof(header)) {
+    throw invalid;
+  }
+  std::memcpy(&header, bytes, sizeof(header));
+  if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+      header.version != WORKSPACE_VERSION || header.indexOffset > size) {
+    throw invalid;
+  }
+
+  std::vector<std::pair<std::string, StoredVariable>> variables;
+  size_t position = header.indexOffset;
+  for (uint64_t i = 0; i < header.count; ++i) {
+    uint64_t offset = 0;
+    uint32_t length = 0;
+    if (size - position < sizeof(offset) + sizeof(length)) {
+      throw invalid;
+    }
+    std::memcpy(&offset, bytes + position, sizeof(offset));
+    std::memcpy(&length, bytes + position + sizeof(offset), sizeof(length));
+    position += sizeof(offset) + sizeof(length);
+    if (size - position < length || offset >= header.indexOffset ||
+        offset % MATRIX_ALIGNMENT != 0) {
+      throw invalid;
+    }
+    variables.emplace_back(std::string(bytes + position, length),
+                           StoredVariable{file, static_cast<size_t>(offset)});
+    position += length;
+  }
+  return variables;
+}
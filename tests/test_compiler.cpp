@@ -0,0 +1,76 @@
+#include "Compiler.h"
+#include "Lexer.h"
+#include "Parser.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+auto compileSource(const std::string &source)
+    -> std::shared_ptr<const Program> {
+  Lexer lexer(source);
+  Parser parser(lexer.scanTokens());
+  return Compiler::compile(parser.parse());
+}
+
+} // namespace
+
+TEST(CompilerTest, Assignment) {
+  auto program = compileSource("A = B * [1, 2]");
+  ASSERT_EQ(program->code.size(), 4);
+  EXPECT_EQ(program->code[0].op, OpCode::LOAD_VAR);
+  EXPECT_EQ(program->code[1].op, OpCode::LOAD_CONST);
+  EXPECT_EQ(program->code[2].op, OpCode::MUL);
+  EXPECT_EQ(program->code[3].op, OpCode::STORE_VAR);
+  EXPECT_EQ(program->names[program->code[3].a], "A");
+  EXPECT_EQ(program->constants.size(), 1);
+}
+
+TEST(CompilerTest, RegistersFollowTreeDepth) {
+  auto flat = compileSource("A * B - C");
+  EXPECT_EQ(flat->registerCount, 3);
+  EXPECT_EQ(flat->result, 0);
+
+  auto nested = compileSource("A * (B * C - D)");
+  EXPECT_EQ(nested->registerCount, 4);
+}
+
+TEST(CompilerTest, ProductChainIsOneInstruction) {
+  for (const char *source : {"A * B * C * D", "A * (B * (C * D))"}) {
+    auto program = compileSource(source);
+    ASSERT_EQ(program->code.size(), 5);
+    EXPECT_EQ(program->code[4].op, OpCode::CHAIN);
+    EXPECT_EQ(program->code[4].dst, 0);
+    EXPECT_EQ(program->code[4].a, 4);
+    EXPECT_EQ(program->registerCount, 4);
+    EXPECT_EQ(program->result, 0);
+  }
+
+  // A scalar literal factor is fused instead, leaving a two-factor product.
+  auto scaled = compileSource("A * B * 2");
+  EXPECT_EQ(scaled->code.back().op, OpCode::FUSED);
+  EXPECT_EQ(scaled->code[scaled->code.size() - 2].op, OpCode::MUL);
+}
+
+TEST(CompilerTest, ElementwiseStatementIsOneKernel) {
+  auto program = compileSource("D = A + B - C * 2 + E");
+  ASSERT_EQ(program->code.size(), 1);
+  EXPECT_EQ(program->code[0].op, OpCode::FUSED);
+  EXPECT_EQ(program->names[program->code[0].b], "D");
+
+  const FusedKernel &kernel = program->kernels[program->code[0].a];
+  EXPECT_EQ(kernel.operands.size(), 4);
+  EXPECT_EQ(kernel.steps.size(), 8);
+  EXPECT_EQ(kernel.depth, 2);
+}
+
+TEST(CompilerTest, ProductsAreKernelInputs) {
+  auto program = compileSource("A + B * C");
+  ASSERT_EQ(program->code.size(), 4);
+  EXPECT_EQ(program->code[2].op, OpCode::MUL);
+  EXPECT_EQ(program->code[3].op, OpCode::FUSED);
+
+  const FusedKernel &kernel = program->kernels[program->code[3].a];
+  ASSERT_EQ(kernel.operands.size(), 2);
+  EXPECT_EQ(kernel.operands[0].source, FusedOperand::Source::VARIABLE);
+  EXPECT_EQ(kernel.operands[1].source, FusedOperand::Source::REGISTER);
+}
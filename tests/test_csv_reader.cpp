@@ -0,0 +1,73 @@
+#include "CsvReader.h"
+#include "ThreadPool.h"
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+
+namespace {
+
+auto writeFile(const std::string &name, const std::string &contents)
+    -> std::string {
+  const std::string path = ::testing::TempDir() + name;
+  std::ofstream(path, std::ios::binary) << contents;
+  return path;
+}
+
+} // namespace
+
+TEST(CsvReaderTest, ParsesDelimitersAndHeader) {
+  const std::string path =
+      writeFile("small.csv", "x, y, z\r\n1, -2.5, 3e2\r\n\r\n4,+5 , .5\n");
+  Matrix<double> m = readCsv(path);
+  ASSERT_EQ(m.getRows(), 2);
+  ASSERT_EQ(m.getCols(), 3);
+  EXPECT_EQ(m(0, 1), -2.5);
+  EXPECT_EQ(m(0, 2), 300);
+  EXPECT_EQ(m(1, 1), 5);
+  EXPECT_EQ(m(1, 2), 0.5);
+
+  Matrix<double> tsv = readCsv(writeFile("small.tsv", "1\t2\n  3   4"));
+  ASSERT_EQ(tsv.getRows(), 2);
+  EXPECT_EQ(tsv(1, 1), 4);
+
+  EXPECT_EQ(readCsv(writeFile("empty.csv", "\n\n")).size(), 0);
+}
+
+TEST(CsvReaderTest, ReportsErrorsWithLineNumbers) {
+  try {
+    readCsv(writeFile("ragged.csv", "1, 2\n3, 4\n\n5\n"));
+    FAIL() << "Expected an error";
+  } catch (const std::runtime_error &e) {
+    EXPECT_NE(std::string(e.what()).find("line 4"), std::string::npos);
+  }
+  EXPECT_THROW(readCsv(writeFile("bad.csv", "a, b\n1, x\n")),
+               std::runtime_error);
+  EXPECT_THROW(readCsv(writeFile("comma.csv", "1, 2\n3, 4,\n")),
+               std::runtime_error);
+  EXPECT_THROW(readCsv(::testing::TempDir() + "missing.csv"),
+               std::runtime_error);
+}
+
+TEST(CsvReaderTest, ParallelChunksMatchFileOrder) {
+  ThreadPool &pool = ThreadPool::instance();
+  const size_t threads = pool.threadCount();
+  pool.setThreadCount(4);
+
+  // About 4 MiB, so the file is split into several chunks.
+  const size_t rows = 150000;
+  std::string text = "a,b,c\n";
+  for (size_t i = 0; i < rows; ++i) {
+    text += std::to_string(i) + ", " + std::to_string(i * 2) + ".25, -" +
+            std::to_string(i % 7) + "\n";
+  }
+  Matrix<double> m = readCsv(writeFile("large.csv", text));
+  pool.setThreadCount(threads);
+
+  ASSERT_EQ(m.getRows(), rows);
+  ASSERT_EQ(m.getCols(), 3);
+  for (size_t i = 0; i < rows; i += 997) {
+    EXPECT_EQ(m(i, 0), static_cast<double>(i));
+    EXPECT_EQ(m(i, 1), static_cast<double>(i * 2) + 0.25);
+    EXPECT_EQ(m(i, 2), -static_cast<double>(i % 7));
+  }
+}
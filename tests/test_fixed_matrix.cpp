@@ -0,0 +1,63 @@
+#include "FixedMatrix.h"
+#include <gtest/gtest.h>
+#include <type_traits>
+
+namespace {
+
+constexpr FixedMatrix<int, 2, 3> A{{1, 2, 3}, {4, 5, 6}};
+constexpr FixedMatrix<int, 3, 2> B{{7, 8}, {9, 10}, {11, 12}};
+
+// Everything below is evaluated by the compiler.
+static_assert(A(1, 2) == 6);
+static_assert((A * B)(0, 0) == 58 && (A * B)(1, 1) == 154);
+static_assert(A.transpose()(2, 1) == 6);
+static_assert((A + A - A) == A);
+static_assert((2 * A)(1, 0) == 8);
+static_assert(FixedMatrix<int, 3, 3>::identity() * B == B);
+static_assert(std::is_trivially_copyable_v<FixedMatrix<double, 4, 4>>);
+static_assert(sizeof(FixedMatrix<double, 4, 4>) == 16 * sizeof(double));
+
+} // namespace
+
+TEST(FixedMatrixTest, Construction) {
+  FixedMatrix<double, 2, 2> zero;
+  EXPECT_EQ(zero(1, 1), 0);
+  EXPECT_EQ((FixedMatrix<double, 2, 2>::getRows()), 2);
+  EXPECT_EQ((FixedMatrix<double, 2, 3>::size()), 6);
+  EXPECT_THROW((FixedMatrix<double, 2, 2>{{1, 2}}), std::invalid_argument);
+  EXPECT_THROW((FixedMatrix<double, 2, 2>{{1, 2}, {3}}),
+               std::invalid_argument);
+}
+
+TEST(FixedMatrixTest, ConvertsToAndFromMatrix) {
+  const Matrix<double> dynamic{{1, 2, 3}, {4, 5, 6}};
+  const FixedMatrix<double, 2, 3> fixed(dynamic);
+  EXPECT_EQ(fixed(1, 0), 4);
+
+  const Matrix<double> back = fixed * 2.0;
+  ASSERT_EQ(back.getRows(), 2);
+  ASSERT_EQ(back.getCols(), 3);
+  EXPECT_EQ(back(1, 2), 12);
+
+  EXPECT_THROW((FixedMatrix<double, 3, 2>(dynamic)), std::invalid_argument);
+}
+
+TEST(FixedMatrixTest, TransformMatchesDynamicProduct) {
+  FixedMatrix<double, 4, 4> transform = FixedMatrix<double, 4, 4>::identity();
+  transform(0, 3) = 1.5;
+  transform(1, 1) = 2.0;
+  transform(2, 0) = -0.5;
+  const FixedMatrix<double, 4, 1> point{{1}, {2}, {3}, {1}};
+
+  FixedMatrix<double, 4, 4> composed = transform * transform;
+  composed -= transform;
+  composed *= 0.5;
+  const FixedMatrix<double, 4, 1> moved = composed * point;
+
+  const Matrix<double> m = transform;
+  const Matrix<double> expected = Matrix<double>(
+      (Matrix<double>(m * m) - m) * 0.5) * Matrix<double>(point);
+  for (size_t i = 0; i < 4; ++i) {
+    EXPECT_DOUBLE_EQ(moved(i, 0), expected(i, 0));
+  }
+}
@@ -1,19 +1,26 @@
 #include "Interpreter.h"
 #include "Lexer.h"
 #include "Parser.h"
+#include "Profiler.h"
 #include <gtest/gtest.h>
+#include <utility>
 
 class InterpreterTest : public ::testing::Test {
 protected:
   Interpreter interpreter;
 
-  Matrix<double> evaluate(const std::string &input) {
+  Value evaluate(const std::string &input) {
     Lexer lexer(input);
     auto tokens = lexer.scanTokens();
     Parser parser(tokens);
     auto expr = parser.parse();
     return interpreter.interpret(expr);
   }
+
+  const double *buffer(const std::string &name) {
+    const Matrix<double> value = interpreter.getVariable(name);
+    return value.raw();
+  }
 };
 
 TEST_F(InterpreterTest, SimpleAddition) {
@@ -55,4 +62,325 @@ TEST_F(InterpreterTest, LastResult) {
   evaluate("2 * 3");
   Matrix<double> result = evaluate("ans * 2");
   EXPECT_EQ(result(0, 0), 12);
-}
\ No newline at end of file
+}
+
+TEST_F(InterpreterTest, CompiledProgramIsCachedAndReusable) {
+  interpreter.setVariable("x", Matrix<double>{{1}});
+  auto program = interpreter.compile("x = x + 1;");
+  EXPECT_EQ(program, interpreter.compile("x = x + 1;"));
+  EXPECT_FALSE(program->printResult);
+
+  for (int i = 0; i < 10; ++i) {
+    interpreter.execute(*program);
+  }
+  EXPECT_EQ(interpreter.getVariable("x")(0, 0), 11);
+  EXPECT_EQ(interpreter.getLastResult()(0, 0), 11);
+}
+
+TEST_F(InterpreterTest, UndefinedVariable) {
+  EXPECT_THROW(evaluate("missing + 1"), std::runtime_error);
+  // A failed statement leaves the interpreter usable.
+  EXPECT_EQ(evaluate("2 * 3")(0, 0), 6);
+}
+
+TEST_F(InterpreterTest, FusedAssignmentReusesDestination) {
+  evaluate("A = [1, 2; 3, 4]");
+  evaluate("B = [5, 6; 7, 8]");
+  evaluate("D = [0, 0; 0, 0]");
+  Matrix<double> result = evaluate("D = A + B - A * 2 + D");
+  EXPECT_EQ(result(0, 0), 4);
+  EXPECT_EQ(result(1, 1), 4);
+
+  // The destination may be read by the expression it receives.
+  evaluate("A = B - A + A * 3");
+  EXPECT_EQ(interpreter.getVariable("A")(1, 0), 13);
+
+  // A failed kernel leaves the destination untouched.
+  EXPECT_THROW(evaluate("A = A + [1, 2]"), std::invalid_argument);
+  EXPECT_EQ(interpreter.getVariable("A")(1, 0), 13);
+  EXPECT_THROW(evaluate("Z = A + [1, 2]"), std::invalid_argument);
+  EXPECT_THROW(interpreter.getVariable("Z"), std::runtime_error);
+}
+
+TEST_F(InterpreterTest, VariablesShareBuffers) {
+  interpreter.setVariable("A", Matrix<double>{{1, 2}, {3, 4}});
+  const double *original = buffer("A");
+
+  Matrix<double> result = evaluate("A");
+  EXPECT_EQ(std::as_const(result).raw(), original);
+  EXPECT_EQ(buffer("ans"), original);
+
+  evaluate("B = A");
+  EXPECT_EQ(buffer("B"), original);
+
+  // Updating one name leaves the others untouched.
+  evaluate("B = B * 2");
+  EXPECT_EQ(interpreter.getVariable("A")(0, 0), 1);
+  EXPECT_EQ(interpreter.getVariable("B")(0, 0), 2);
+  EXPECT_EQ(interpreter.getVariable("ans")(0, 0), 2);
+
+  // Assignments set 'ans', and a failed statement keeps the last result.
+  evaluate("C = A + 1");
+  EXPECT_EQ(interpreter.getVariable("ans")(1, 1), 5);
+  EXPECT_THROW(evaluate("C = A + [1, 2]"), std::invalid_argument);
+  EXPECT_EQ(interpreter.getVariable("ans")(1, 1), 5);
+  EXPECT_EQ(interpreter.getLastResult()(1, 1), 5);
+}
+
+TEST_F(InterpreterTest, UnsharedDestinationIsUpdatedInPlace) {
+  // The first update may move D off a buffer shared with the literal; later
+  // ones reuse the buffer it owns.
+  evaluate("D = [1, 2; 3, 4]");
+  evaluate("D = D * 2;");
+  const double *original = buffer("D");
+  for (int i = 0; i < 3; ++i) {
+    evaluate("D = D * 2;");
+  }
+  EXPECT_EQ(buffer("D"), original);
+  EXPECT_EQ(interpreter.getVariable("D")(1, 1), 64);
+  EXPECT_EQ(interpreter.getVariable("ans")(1, 1), 64);
+
+  // A statement reading 'ans' keeps it.
+  evaluate("D = ans * 2;");
+  EXPECT_EQ(interpreter.getVariable("D")(1, 1), 128);
+  EXPECT_EQ(interpreter.getVariable("ans")(1, 1), 128);
+}
+
+TEST_F(InterpreterTest, CompoundAssignmentUpdatesInPlace) {
+  evaluate("X = [1, 2; 3, 4] * 1");
+  evaluate("Y = [1, 1; 1, 1]");
+  const double *original = buffer("X");
+
+  evaluate("X += Y;");
+  evaluate("X -= Y * 2;");
+  evaluate("X *= 3;");
+  evaluate("X = X + Y;");
+  EXPECT_EQ(buffer("X"), original);
+  EXPECT_EQ(interpreter.getVariable("X")(0, 0), 1);
+  EXPECT_EQ(interpreter.getVariable("X")(1, 1), 10);
+
+  // A matrix product cannot overwrite its own operand.
+  evaluate("X *= [1, 0; 0, 2]");
+  EXPECT_EQ(interpreter.getVariable("X")(1, 1), 20);
+
+  EXPECT_THROW(evaluate("missing += 1"), std::runtime_error);
+  EXPECT_THROW(evaluate("X += [1, 2]"), std::invalid_argument);
+  EXPECT_EQ(interpreter.getVariable("X")(1, 1), 20);
+}
+
+TEST_F(InterpreterTest, MatMulAlgorithmSetting) {
+  EXPECT_EQ(interpreter.getMatMulAlgorithm(), gemm::Algorithm::STANDARD);
+  interpreter.setMatMulAlgorithm(gemm::Algorithm::STRASSEN);
+  Matrix<double> result = evaluate("[1, 2; 3, 4] * [5, 6; 7, 8]");
+  EXPECT_EQ(result(1, 0), 43);
+  EXPECT_EQ(interpreter.getMatMulAlgorithm(), gemm::Algorithm::STRASSEN);
+}
+
+TEST_F(InterpreterTest, ProductChainIsReordered) {
+  Matrix<double> a(60, 60);
+  Matrix<double> v(60, 1);
+  for (size_t i = 0; i < 60; ++i) {
+    a(i, i) = 2;
+    a(i, (i + 1) % 60) = 1;
+    v(i, 0) = static_cast<double>(i);
+  }
+  interpreter.setVariable("A", a);
+  interpreter.setVariable("v", v);
+  interpreter.setVariable("s", Matrix<double>{{0.5}});
+
+  // Right to left costs two matrix-vector products instead of a GEMM.
+  Profiler &profiler = Profiler::instance();
+  profiler.reset();
+  profiler.setEnabled(true);
+  Matrix<double> result = evaluate("A * s * A * v");
+  profiler.setEnabled(false);
+  EXPECT_EQ(profiler.operation(Profiler::Operation::MULTIPLY).flops,
+            2 * 2 * 60 * 60 + 60);
+  profiler.reset();
+
+  Matrix<double> expected = a * a * v * 0.5;
+  ASSERT_EQ(result.getRows(), 60);
+  ASSERT_EQ(result.getCols(), 1);
+  for (size_t i = 0; i < 60; ++i) {
+    EXPECT_EQ(result(i, 0), expected(i, 0));
+  }
+
+  EXPECT_EQ(evaluate("s * s * s")(0, 0), 0.125);
+  EXPECT_THROW(evaluate("A * v * A"), std::invalid_argument);
+
+  // A 1x1 intermediate product scales the rest, as without reordering.
+  for (const char *source : {"[1, 2] * [3; 4] * [1, 2; 3, 4]",
+                             "([1, 2] * [3; 4]) * [1, 2; 3, 4]"}) {
+    const Value scaled = evaluate(source);
+    ASSERT_EQ(scaled.getRows(), 2);
+    ASSERT_EQ(scaled.getCols(), 2);
+    EXPECT_EQ(scaled(0, 0), 11);
+    EXPECT_EQ(scaled(1, 1), 44);
+  }
+}
+
+TEST_F(InterpreterTest, ProductChainKeepsElementTypes) {
+  // Reordering a chain gives the same types, and int32 overflow, as
+  // multiplying from left to right.
+  evaluate("A = int32([1, 2; 3, 4]);");
+  evaluate("k = int32([100000]);");
+  evaluate("t = 65536;");
+  evaluate("u = 3e10;");
+  evaluate("F = single([1, 2; 3, 4]);");
+  // Parentheses do not split a chain, so the left-to-right product is built
+  // from two-operand products.
+  const char *const chains[][3] = {
+      {"k", "k", "k"}, {"A", "k", "k"}, {"k", "k", "A"}, {"A", "t", "t"},
+      {"A", "u", "A"}, {"F", "k", "F"}, {"A", "F", "A"}};
+  for (const auto &chain : chains) {
+    const std::string source =
+        std::string(chain[0]) + " * " + chain[1] + " * " + chain[2];
+    const Value reordered = evaluate(source);
+    evaluate(std::string("L = ") + chain[0] + " * " + chain[1] + ";");
+    const Value expected = evaluate(std::string("L * ") + chain[2]);
+    EXPECT_EQ(reordered.dtype(), expected.dtype()) << source;
+    ASSERT_EQ(reordered.size(), expected.size()) << source;
+    for (size_t i = 0; i < expected.getRows(); ++i) {
+      for (size_t j = 0; j < expected.getCols(); ++j) {
+        EXPECT_EQ(reordered(i, j), expected(i, j)) << source;
+      }
+    }
+  }
+  EXPECT_EQ(evaluate("k * k * k").dtype(), DType::INT32);
+  EXPECT_EQ(evaluate("A * t * t")(1, 1), 0);
+}
+
+TEST_F(InterpreterTest, SparseValuesDispatch) {
+  Matrix<double> a(2, 3);
+  a(0, 0) = 2;
+  a(1, 2) = 3;
+  interpreter.setVariable("A", a);
+  interpreter.setVariable("x", Matrix<double>{{1}, {2}, {3}});
+  evaluate("S = sparse(A);");
+  EXPECT_TRUE(interpreter.getVariable("S").isSparse());
+
+  Matrix<double> product = evaluate("S * x");
+  EXPECT_FALSE(interpreter.getLastResult().isSparse());
+  EXPECT_EQ(product(0, 0), 2);
+  EXPECT_EQ(product(1, 0), 9);
+
+  // Sums and scalings of sparse values stay sparse while they are cheaper
+  // to store than the dense form.
+  Matrix<double> identity(40, 40);
+  for (size_t i = 0; i < 40; ++i) {
+    identity(i, i) = 1;
+  }
+  interpreter.setVariable("I", identity);
+  evaluate("T = 2 * sparse(I) - sparse(I);");
+  EXPECT_TRUE(interpreter.getVariable("T").isSparse());
+  EXPECT_EQ(interpreter.getVariable("T")(39, 39), 1);
+  evaluate("T = S - S;");
+  EXPECT_FALSE(interpreter.getVariable("T").isSparse());
+  evaluate("U = S + A;");
+  EXPECT_FALSE(interpreter.getVariable("U").isSparse());
+  EXPECT_EQ(interpreter.getVariable("U")(1, 2), 6);
+
+  evaluate("D = dense(S);");
+  EXPECT_FALSE(interpreter.getVariable("D").isSparse());
+  EXPECT_THROW(evaluate("S * S"), std::invalid_argument);
+}
+
+TEST_F(InterpreterTest, ScalarArithmeticDoesNotAllocate) {
+  evaluate("x = 1;");
+  EXPECT_TRUE(interpreter.getVariable("x").isScalar());
+  auto program = interpreter.compile("x = x * 2 + 1;");
+  interpreter.execute(*program);
+
+  Profiler &profiler = Profiler::instance();
+  profiler.reset();
+  profiler.setEnabled(true);
+  for (int i = 0; i < 10; ++i) {
+    interpreter.execute(*program);
+  }
+  evaluate("y = x * x - 1");
+  evaluate("z = x * y * x;");
+  profiler.setEnabled(false);
+  EXPECT_EQ(profiler.phase(Profiler::Phase::EVAL).bytes, 0);
+  profiler.reset();
+
+  EXPECT_EQ(interpreter.getVariable("x").scalar(), 4095);
+  EXPECT_TRUE(interpreter.getVariable("y").isScalar());
+  EXPECT_EQ(interpreter.getVariable("y")(0, 0), 4095.0 * 4095.0 - 1);
+  EXPECT_TRUE(interpreter.getVariable("z").isScalar());
+  EXPECT_EQ(interpreter.getVariable("z")(0, 0),
+            4095.0 * (4095.0 * 4095.0 - 1) * 4095.0);
+}
+
+TEST_F(InterpreterTest, ScalarsBroadcast) {
+  Matrix<double> a(30, 30);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a.raw()[i] = static_cast<double>(i);
+  }
+  interpreter.setVariable("A", a);
+  interpreter.setVariable("s", 0.5);
+
+  Matrix<double> result = evaluate("1 - A * 2 + s");
+  ASSERT_EQ(result.getRows(), 30);
+  ASSERT_EQ(result.getCols(), 30);
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_EQ(result.raw()[i], 1.5 - 2.0 * a.raw()[i]);
+  }
+  EXPECT_EQ(evaluate("s * A")(29, 29), a(29, 29) / 2);
+  EXPECT_EQ(evaluate("A - [1]")(0, 1), 0);
+  evaluate("A += s;");
+  EXPECT_EQ(interpreter.getVariable("A")(0, 0), 0.5);
+  EXPECT_THROW(evaluate("A + [1, 2]"), std::invalid_argument);
+}
+
+TEST_F(InterpreterTest, ElementTypesArePromoted) {
+  evaluate("A = single([1.5, 2; 3, 4]);");
+  EXPECT_EQ(interpreter.getVariable("A").dtype(), DType::FLOAT32);
+
+  // Scalars take the matrix's type; kernels run in it and update in place.
+  const float *data = nullptr;
+  {
+    const Value before = interpreter.getVariable("A");
+    data = before.get<Matrix<float>>().raw();
+  }
+  evaluate("A = A * 2 + 1;");
+  const Value a = interpreter.getVariable("A");
+  EXPECT_EQ(a.dtype(), DType::FLOAT32);
+  EXPECT_EQ(a.get<Matrix<float>>().raw(), data);
+  EXPECT_EQ(a(0, 0), 4);
+  EXPECT_EQ(evaluate("A * A").dtype(), DType::FLOAT32);
+
+  evaluate("I = int32(A - 0.5);");
+  Value i = interpreter.getVariable("I");
+  EXPECT_EQ(i.dtype(), DType::INT32);
+  EXPECT_EQ(i(0, 0), 4); // 3.5 rounds away from zero
+  EXPECT_EQ(evaluate("I * 2 - I").dtype(), DType::INT32);
+  EXPECT_EQ(evaluate("I * 0.5").dtype(), DType::FLOAT64);
+  EXPECT_EQ(evaluate("I + 0.5")(0, 0), 4.5);
+
+  // Mixed matrix types are computed in float64.
+  EXPECT_EQ(evaluate("I + A").dtype(), DType::FLOAT64);
+  EXPECT_EQ(evaluate("A - double(A)").dtype(), DType::FLOAT64);
+  EXPECT_EQ(evaluate("I * A")(0, 0), 4 * 4 + 5 * 7);
+  EXPECT_EQ(evaluate("double(A)").dtype(), DType::FLOAT64);
+  EXPECT_TRUE(evaluate("double(2)").isScalar());
+
+  // Scalars outside int32's range promote; int32 arithmetic wraps around.
+  const Value far = evaluate("int32([1, 2]) + 3e10");
+  EXPECT_EQ(far.dtype(), DType::FLOAT64);
+  EXPECT_EQ(far(0, 1), 3e10 + 2);
+  EXPECT_EQ(evaluate("int32([1, 2]) * 3e9").dtype(), DType::FLOAT64);
+  evaluate("M = int32([2147483647, 1] - [0, 2147483648]);");
+  EXPECT_EQ(evaluate("M + 1")(0, 0), -2147483648.0);
+  EXPECT_EQ(evaluate("M - 2")(0, 1), 2147483647);
+  EXPECT_EQ(evaluate("M * 2")(0, 0), -2);
+  EXPECT_EQ(evaluate("M * int32([2; 0])")(0, 0), -2);
+}
+
+TEST_F(InterpreterTest, DeadlineStopsExecution) {
+  evaluate("x = 1;");
+  interpreter.setDeadline(std::chrono::steady_clock::now() -
+                          std::chrono::seconds(1));
+  EXPECT_THROW(evaluate("x = x + 1;"), std::runtime_error);
+  interpreter.setDeadline(Interpreter::NO_DEADLINE);
+  EXPECT_EQ(evaluate("x")(0, 0), 1);
+}
@@ -1,5 +1,6 @@
 #include "Lexer.h"
 #include <gtest/gtest.h>
+#include <string>
 
 TEST(LexerTest, Numbers) {
   Lexer lexer("123.456");
@@ -40,4 +41,52 @@ TEST(LexerTest, Variables) {
   EXPECT_EQ(tokens[2].type, TokenType::IDENTIFIER);
   EXPECT_EQ(tokens[3].type, TokenType::PLUS);
   EXPECT_EQ(tokens[4].type, TokenType::IDENTIFIER);
-}
\ No newline at end of file
+}
+
+TEST(LexerTest, CompoundAssignment) {
+  Lexer lexer("A += B -= C *= 2");
+  auto tokens = lexer.scanTokens();
+
+  EXPECT_EQ(tokens[1].type, TokenType::PLUS_ASSIGN);
+  EXPECT_EQ(tokens[3].type, TokenType::MINUS_ASSIGN);
+  EXPECT_EQ(tokens[5].type, TokenType::MULTIPLY_ASSIGN);
+}
+
+TEST(LexerTest, TokensViewTheSource) {
+  const std::string source = "x = 0.25 * 40";
+  Lexer lexer(source);
+  auto tokens = lexer.scanTokens();
+
+  EXPECT_EQ(tokens[0].lexeme.data(), source.data());
+  EXPECT_EQ(tokens[2].lexeme, "0.25");
+  EXPECT_EQ(tokens[2].number, 0.25);
+  EXPECT_EQ(tokens[4].number, 40);
+  EXPECT_EQ(tokens[3].lexeme.data(), source.data() + 9);
+}
+
+TEST(LexerTest, Strings) {
+  Lexer lexer("load(\"data/a b.nlm\") \"open");
+  auto tokens = lexer.scanProgram();
+
+  EXPECT_EQ(tokens[2].type, TokenType::STRING);
+  EXPECT_EQ(tokens[2].lexeme, "data/a b.nlm");
+  EXPECT_EQ(tokens[4].type, TokenType::ERROR);
+}
+
+TEST(LexerTest, ScanNumber) {
+  const std::string text = "2.5e-3x 7e 12.";
+  double value = 0;
+  const char *end =
+      Lexer::scanNumber(text.data(), text.data() + text.size(), value);
+  EXPECT_EQ(end, text.data() + 6);
+  EXPECT_EQ(value, 2.5e-3);
+
+  // An exponent or a decimal point without digits is not consumed.
+  EXPECT_EQ(Lexer::scanNumber(text.data() + 8, text.data() + 10, value),
+            text.data() + 9);
+  EXPECT_EQ(value, 7);
+  EXPECT_EQ(Lexer::scanNumber(text.data() + 11, text.data() + 14, value),
+            text.data() + 13);
+  EXPECT_EQ(Lexer::scanNumber(text.data() + 7, text.data() + 8, value),
+            nullptr);
+}
@@ -1,5 +1,9 @@
 #include "Matrix.h"
+#include "Simd.h"
+#include <cmath>
+#include <cstdint>
 #include <gtest/gtest.h>
+#include <utility>
 
 TEST(MatrixTest, Construction) {
   Matrix<double> m1(2, 2);
@@ -43,4 +47,176 @@ TEST(MatrixTest, ScalarMultiplication) {
   EXPECT_EQ(result(0, 1), 4);
   EXPECT_EQ(result(1, 0), 6);
   EXPECT_EQ(result(1, 1), 8);
-}
\ No newline at end of file
+}
+
+TEST(MatrixTest, ContiguousAlignedStorage) {
+  Matrix<double> m{{1, 2, 3}, {4, 5, 6}};
+  EXPECT_EQ(m.getStride(), 3);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(m.raw()) % MATRIX_ALIGNMENT, 0);
+  EXPECT_EQ(m.rowPtr(1), m.raw() + 3);
+  EXPECT_EQ(m.raw()[4], 5);
+
+  EXPECT_THROW((Matrix<double>{{1, 2}, {3}}), std::invalid_argument);
+}
+
+TEST(MatrixTest, BlockedMultiplicationMatchesSimple) {
+  // Odd sizes exercise the partial MR x NR tiles and KC remainder, for the
+  // micro-kernel of every instruction set level.
+  const size_t m = 97;
+  const size_t k = 301;
+  const size_t n = 83;
+  auto check = [&](auto zero) {
+    using T = decltype(zero);
+    Matrix<T> a(m, k);
+    Matrix<T> b(k, n);
+    for (size_t i = 0; i < a.size(); ++i) {
+      a.raw()[i] = static_cast<T>((i * 7) % 13) - T(6);
+    }
+    for (size_t i = 0; i < b.size(); ++i) {
+      b.raw()[i] = static_cast<T>((i * 5) % 11) - T(5);
+    }
+
+    Matrix<T> expected(m, n);
+    gemm::simple(m, n, k, a.raw(), k, b.raw(), n, expected.raw(), n);
+    const simd::Level previous = simd::level();
+    for (simd::Level level : {simd::Level::SCALAR, simd::Level::AVX2,
+                              simd::Level::AVX512}) {
+      simd::setLevel(level);
+      Matrix<T> result(m, n);
+      gemm::blocked(m, n, k, a.raw(), k, b.raw(), n, result.raw(), n);
+      for (size_t i = 0; i < result.size(); ++i) {
+        EXPECT_EQ(result.raw()[i], expected.raw()[i]);
+      }
+    }
+    simd::setLevel(previous);
+    Matrix<T> viaOperator = a * b;
+    EXPECT_EQ(viaOperator(m - 1, n - 1), expected(m - 1, n - 1));
+  };
+  check(0.0);
+  check(0.0f);
+}
+
+TEST(MatrixTest, StrassenMatchesBlocked) {
+  // Small integers keep every intermediate exact, so the results must agree
+  // bit for bit. 1024 splits evenly; 601 is padded to 602.
+  for (const size_t n : {size_t(1024), size_t(601)}) {
+    Matrix<double> a(n, n);
+    Matrix<double> b(n, n);
+    for (size_t i = 0; i < a.size(); ++i) {
+      a.raw()[i] = static_cast<double>((i * 7) % 13) - 6.0;
+      b.raw()[i] = static_cast<double>((i * 5) % 11) - 5.0;
+    }
+
+    Matrix<double> expected = a * b;
+    Matrix<double> result = a.multiply(b, gemm::Algorithm::STRASSEN);
+    ASSERT_EQ(result.getRows(), n);
+    for (size_t i = 0; i < result.size(); ++i) {
+      ASSERT_EQ(result.raw()[i], expected.raw()[i]) << "n = " << n;
+    }
+  }
+
+  // Non-square products are unaffected.
+  Matrix<double> tall(3, 2);
+  tall(2, 1) = 2;
+  Matrix<double> wide{{1, 2, 3}, {4, 5, 6}};
+  EXPECT_EQ(tall.multiply(wide, gemm::Algorithm::STRASSEN)(2, 2), 12);
+}
+
+TEST(MatrixTest, FusedExpressionChain) {
+  Matrix<double> a{{1, 2}, {3, 4}};
+  Matrix<double> b{{5, 6}, {7, 8}};
+  Matrix<double> c{{1, 1}, {2, 2}};
+
+  Matrix<double> result = a + b - c * 2;
+  EXPECT_EQ(result(0, 0), 4);
+  EXPECT_EQ(result(1, 1), 8);
+
+  // The destination may appear anywhere in the expression.
+  a = b - a + a * 3;
+  EXPECT_EQ(a(0, 0), 7);
+  EXPECT_EQ(a(1, 1), 16);
+
+  a += b - c;
+  EXPECT_EQ(a(1, 0), 18);
+
+  EXPECT_THROW(Matrix<double>(a + Matrix<double>(3, 3)), std::invalid_argument);
+}
+
+TEST(MatrixTest, ExpressionOperandsOfProduct) {
+  Matrix<double> a{{1, 2}, {3, 4}};
+  Matrix<double> b{{5, 6}, {7, 8}};
+  Matrix<double> result = (a + a) * (b - a);
+  EXPECT_EQ(result(0, 0), 2 * (4 + 8));
+  EXPECT_EQ(result(1, 1), 6 * 4 + 8 * 4);
+}
+
+TEST(MatrixTest, LargeExpressionUsesStreamingStores) {
+  const size_t saved = simd::streamingThreshold();
+  simd::setStreamingThreshold(0);
+  Matrix<double> a(37, 41);
+  Matrix<double> b(37, 41);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a.raw()[i] = static_cast<double>(i);
+    b.raw()[i] = 1.0;
+  }
+  Matrix<double> result = a * 2 - b;
+  simd::setStreamingThreshold(saved);
+
+  for (size_t i = 0; i < result.size(); ++i) {
+    EXPECT_EQ(result.raw()[i], 2.0 * static_cast<double>(i) - 1.0);
+  }
+}
+
+TEST(MatrixTest, CopiesShareBufferUntilWritten) {
+  Matrix<double> a{{1, 2}, {3, 4}};
+  const double *buffer = std::as_const(a).raw();
+
+  Matrix<double> b = a;
+  EXPECT_TRUE(a.isShared());
+  EXPECT_EQ(std::as_const(b).raw(), buffer);
+
+  b(0, 0) = 10;
+  EXPECT_FALSE(a.isShared());
+  EXPECT_FALSE(b.isShared());
+  EXPECT_EQ(std::as_const(a).raw(), buffer);
+  EXPECT_EQ(a(0, 0), 1);
+  EXPECT_EQ(b(0, 0), 10);
+
+  Matrix<double> c = a;
+  c += a;
+  EXPECT_EQ(a(1, 1), 4);
+  EXPECT_EQ(c(1, 1), 8);
+
+  // Assigning an expression to a shared matrix must not write through.
+  Matrix<double> d = a;
+  d = a + a;
+  EXPECT_EQ(a(0, 1), 2);
+  EXPECT_EQ(d(0, 1), 4);
+}
+
+TEST(MatrixTest, AdoptsStorageWithoutCopying) {
+  Matrix<double>::Storage values{1, 2, 3, 4, 5, 6};
+  const double *data = values.data();
+
+  Matrix<double> m(2, 3, std::move(values));
+  EXPECT_EQ(std::as_const(m).raw(), data);
+  EXPECT_EQ(m(1, 0), 4);
+
+  Matrix<double>::Storage wrong{1, 2, 3};
+  EXPECT_THROW(Matrix<double>(2, 2, std::move(wrong)), std::invalid_argument);
+}
+
+TEST(MatrixTest, CastRoundsAndSaturates) {
+  const Matrix<double> a{{1.5, -2.5, 1e12}, {-1e12, 0.25, std::nan("")}};
+  const Matrix<int32_t> rounded = a.cast<int32_t>();
+  EXPECT_EQ(rounded(0, 0), 2);
+  EXPECT_EQ(rounded(0, 1), -3);
+  EXPECT_EQ(rounded(0, 2), INT32_MAX);
+  EXPECT_EQ(rounded(1, 0), INT32_MIN);
+  EXPECT_EQ(rounded(1, 2), 0);
+
+  const Matrix<float> single = a.cast<float>();
+  EXPECT_EQ(single(1, 1), 0.25F);
+  const Matrix<double> same = a.cast<double>();
+  EXPECT_EQ(same.raw(), a.raw());
+}
@@ -0,0 +1,143 @@
+#include "Interpreter.h"
+#include "MatrixFile.h"
+#include <cstdint>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+
+namespace {
+
+auto tempPath(const std::string &name) -> std::string {
+  return ::testing::TempDir() + name;
+}
+
+} // namespace
+
+TEST(MatrixFileTest, RoundTripIsMappedWithoutCopy) {
+  Matrix<double> original(37, 23);
+  for (size_t i = 0; i < original.size(); ++i) {
+    original.raw()[i] = static_cast<double>(i) * 0.5;
+  }
+  const std::string path = tempPath("round_trip.nlm");
+  saveMatrix(original, path);
+
+  Matrix<double> loaded = loadMatrix(path);
+  ASSERT_EQ(loaded.getRows(), 37);
+  ASSERT_EQ(loaded.getCols(), 23);
+  const double *data = std::as_const(loaded).raw();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % MATRIX_ALIGNMENT, 0);
+  for (size_t i = 0; i < original.size(); ++i) {
+    EXPECT_EQ(data[i], original.raw()[i]);
+  }
+
+  // Writes stay private to the process and never reach the file.
+  loaded(0, 0) = 42;
+  EXPECT_EQ(loadMatrix(path)(0, 0), 0);
+  Matrix<double> copy = loaded;
+  copy(1, 1) = 7;
+  EXPECT_EQ(loaded(1, 1), original(1, 1));
+}
+
+TEST(MatrixFileTest, RejectsInvalidFiles) {
+  EXPECT_THROW(loadMatrix(tempPath("missing.nlm")), std::runtime_error);
+
+  const std::string path = tempPath("invalid.nlm");
+  std::ofstream(path) << "not a matrix file";
+  EXPECT_THROW(loadMatrix(path), std::runtime_error);
+
+  // A header promising more data than the file holds.
+  saveMatrix(Matrix<double>(4, 4), path);
+  std::ofstream(path, std::ios::binary | std::ios::in | std::ios::out)
+      .seekp(8)
+      .put(5);
+  EXPECT_THROW(loadMatrix(path), std::runtime_error);
+}
+
+TEST(MatrixFileTest, LoadAndSaveBuiltins) {
+  Interpreter interpreter;
+  const std::string path = tempPath("builtins.nlm");
+  interpreter.setVariable("A", Matrix<double>{{1, 2}, {3, 4}});
+
+  auto run = [&interpreter](const std::string &source) {
+    return interpreter.execute(*interpreter.compile(source));
+  };
+  run("7");
+  run("save(A * 2, \"" + path + "\")");
+  EXPECT_EQ(interpreter.getVariable("ans")(0, 0), 7);
+
+  Matrix<double> result = run("B = load(\"" + path + "\") + A");
+  EXPECT_EQ(result(1, 1), 12);
+  EXPECT_EQ(run("load(\"" + path + "\")")(0, 1), 4);
+
+  EXPECT_THROW(run("load(A)"), std::runtime_error);
+  EXPECT_THROW(run("save(A)"), std::runtime_error);
+  EXPECT_THROW(run("missing(A)"), std::runtime_error);
+  EXPECT_THROW(run("A + \"text\""), std::runtime_error);
+}
+
+TEST(MatrixFileTest, ResavingLoadedMatrixKeepsIt) {
+  Interpreter interpreter;
+  const std::string path = tempPath("resave.nlm");
+  auto run = [&interpreter](const std::string &source) {
+    return interpreter.execute(*interpreter.compile(source));
+  };
+  run("A = [1, 2; 3, 4];");
+  run("save(A, \"" + path + "\")");
+  run("B = load(\"" + path + "\");");
+  run("save(B, \"" + path + "\")");
+  run("save(B * 2, \"" + path + "\")");
+
+  const Matrix<double> b = interpreter.getVariable("B");
+  EXPECT_EQ(b(0, 0), 1);
+  EXPECT_EQ(b(1, 1), 4);
+  EXPECT_EQ(loadMatrix(path)(1, 1), 8);
+}
+
+TEST(MatrixFileTest, KeepsElementTypes) {
+  Interpreter interpreter;
+  const std::string path = tempPath("types.nlm");
+  auto run = [&interpreter](const std::string &source) {
+    return interpreter.execute(*interpreter.compile(source));
+  };
+
+  run("save(single([1.5, 2; 3, 4]), \"" + path + "\")");
+  const Value single = loadMatrix(path);
+  ASSERT_EQ(single.dtype(), DType::FLOAT32);
+  EXPECT_EQ(single(0, 0), 1.5);
+  const float *data = single.get<Matrix<float>>().raw();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % MATRIX_ALIGNMENT, 0);
+
+  run("save(int32([2147483647, 1]), \"" + path + "\")");
+  const Value sum = run("load(\"" + path + "\") * 2");
+  EXPECT_EQ(sum.dtype(), DType::INT32);
+  EXPECT_EQ(sum(0, 0), -2);
+
+  run("save(3, \"" + path + "\")");
+  EXPECT_TRUE(loadMatrix(path).isScalar());
+}
+
+TEST(MatrixFileTest, SparseMatricesStayCompressed) {
+  Matrix<double> dense(1000, 2000);
+  dense(3, 1999) = 2;
+  dense(999, 0) = 5;
+  const std::string path = tempPath("sparse.nlm");
+  saveMatrix(SparseMatrix<double>::fromDense(dense), path);
+  EXPECT_LT(std::ifstream(path, std::ios::binary | std::ios::ate).tellg(),
+            16 * 1024);
+
+  const Value loaded = loadMatrix(path);
+  ASSERT_TRUE(loaded.isSparse());
+  EXPECT_EQ(loaded.getRows(), 1000);
+  EXPECT_EQ(loaded.getCols(), 2000);
+  EXPECT_EQ(loaded.sparse().nonZeros(), 2);
+  EXPECT_EQ(loaded(3, 1999), 2);
+  EXPECT_EQ(loaded(999, 0), 5);
+
+  // A column index past the last column.
+  std::ofstream(path, std::ios::binary | std::ios::in | std::ios::out)
+      .seekp(static_cast<std::streamoff>(sizeof(MatrixFileHeader) +
+                                         1001 * sizeof(uint64_t)))
+      .put(static_cast<char>(0xff));
+  EXPECT_THROW(loadMatrix(path), std::runtime_error);
+}
@@ -1,6 +1,7 @@
 #include "Lexer.h"
 #include "Parser.h"
 #include <gtest/gtest.h>
+#include <string>
 
 TEST(ParserTest, SimpleExpression) {
   Lexer lexer("1 + 2");
@@ -8,7 +9,7 @@ TEST(ParserTest, SimpleExpression) {
   Parser parser(tokens);
 
   auto expr = parser.parse();
-  EXPECT_NE(dynamic_cast<BinaryExpr *>(expr.get()), nullptr);
+  EXPECT_EQ(expr->kind, ExprKind::BINARY);
 }
 
 TEST(ParserTest, MatrixLiteral) {
@@ -17,7 +18,7 @@ TEST(ParserTest, MatrixLiteral) {
   Parser parser(tokens);
 
   auto expr = parser.parse();
-  EXPECT_NE(dynamic_cast<LiteralExpr *>(expr.get()), nullptr);
+  EXPECT_EQ(expr->kind, ExprKind::LITERAL);
 }
 
 TEST(ParserTest, Assignment) {
@@ -26,7 +27,7 @@ TEST(ParserTest, Assignment) {
   Parser parser(tokens);
 
   auto expr = parser.parse();
-  EXPECT_NE(dynamic_cast<AssignExpr *>(expr.get()), nullptr);
+  EXPECT_EQ(expr->kind, ExprKind::ASSIGN);
 }
 
 TEST(ParserTest, ComplexExpression) {
@@ -35,5 +36,87 @@ TEST(ParserTest, ComplexExpression) {
   Parser parser(tokens);
 
   auto expr = parser.parse();
-  EXPECT_NE(dynamic_cast<BinaryExpr *>(expr.get()), nullptr);
-}
\ No newline at end of file
+  EXPECT_EQ(expr->kind, ExprKind::BINARY);
+}
+
+TEST(ParserTest, CompoundAssignment) {
+  Lexer lexer("A -= B * 2");
+  auto tokens = lexer.scanTokens();
+  Parser parser(tokens);
+
+  auto expr = parser.parse();
+  ASSERT_EQ(expr->kind, ExprKind::ASSIGN);
+  auto *assign = static_cast<AssignExpr *>(expr.get());
+  ASSERT_EQ(assign->value->kind, ExprKind::BINARY);
+  auto *update = static_cast<BinaryExpr *>(assign->value);
+  EXPECT_EQ(update->op, TokenType::MINUS);
+  EXPECT_EQ(update->left->kind, ExprKind::VARIABLE);
+
+  Lexer invalid("[1] += 2");
+  auto invalidTokens = invalid.scanTokens();
+  Parser invalidParser(invalidTokens);
+  EXPECT_THROW(invalidParser.parse(), std::runtime_error);
+}
+
+TEST(ParserTest, NodesAreTagged) {
+  Lexer lexer("x = 2 * [1, 2] - y");
+  auto tokens = lexer.scanTokens();
+  Parser parser(tokens);
+
+  auto expr = parser.parse();
+  ASSERT_EQ(expr->kind, ExprKind::ASSIGN);
+  const auto *assign = static_cast<const AssignExpr *>(expr.get());
+  EXPECT_EQ(assign->name, "x");
+  ASSERT_EQ(assign->value->kind, ExprKind::BINARY);
+  const auto *minus = static_cast<const BinaryExpr *>(assign->value);
+  EXPECT_EQ(minus->right->kind, ExprKind::VARIABLE);
+  ASSERT_EQ(minus->left->kind, ExprKind::BINARY);
+  const auto *times = static_cast<const BinaryExpr *>(minus->left);
+  EXPECT_EQ(times->left->kind, ExprKind::NUMBER);
+  EXPECT_EQ(times->right->kind, ExprKind::LITERAL);
+}
+
+TEST(ParserTest, LargeMatrixLiteral) {
+  std::string source = "[";
+  for (int i = 0; i < 300; ++i) {
+    for (int j = 0; j < 200; ++j) {
+      source += std::to_string(i * 200 + j) + (j + 1 < 200 ? ", " : "");
+    }
+    source += "; ";
+  }
+  source += "]";
+  Lexer lexer(source);
+  auto tokens = lexer.scanTokens();
+  Parser parser(tokens);
+
+  auto expr = parser.parse();
+  ASSERT_EQ(expr->kind, ExprKind::LITERAL);
+  const Matrix<double> &value = static_cast<LiteralExpr *>(expr.get())->value;
+  EXPECT_EQ(value.getRows(), 300);
+  EXPECT_EQ(value.getCols(), 200);
+  EXPECT_EQ(value(299, 199), 59999);
+
+  Lexer ragged("[1, 2; 3, 4, 5; 6, 7]");
+  auto raggedTokens = ragged.scanTokens();
+  Parser raggedParser(raggedTokens);
+  EXPECT_THROW(raggedParser.parse(), std::runtime_error);
+}
+
+TEST(ParserTest, ProgramRecoversFromErrors) {
+  Lexer lexer("A = [1, 2\n 3, 4]; B = A\nA + $\n\nC = (A\nA * 2");
+  auto tokens = lexer.scanProgram();
+  Parser parser(tokens);
+
+  auto statements = parser.parseProgram();
+  ASSERT_EQ(statements.size(), 5);
+  EXPECT_EQ(statements[0].line, 1);
+  EXPECT_FALSE(statements[0].printResult);
+  EXPECT_EQ(statements[1].line, 2);
+  EXPECT_TRUE(statements[1].printResult);
+  EXPECT_EQ(statements[2].expression, nullptr);
+  EXPECT_EQ(statements[2].line, 3);
+  EXPECT_EQ(statements[3].expression, nullptr);
+  EXPECT_EQ(statements[3].line, 5);
+  EXPECT_EQ(statements[4].line, 6);
+  EXPECT_EQ(statements[4].expression->kind, ExprKind::BINARY);
+}
@@ -0,0 +1,70 @@
+#include "Interpreter.h"
+#include "Profiler.h"
+#include "Runner.h"
+#include <gtest/gtest.h>
+#include <sstream>
+
+namespace {
+
+class ProfilerTest : public ::testing::Test {
+protected:
+  void SetUp() override {
+    profiler.reset();
+    profiler.setEnabled(true);
+  }
+
+  void TearDown() override {
+    profiler.setEnabled(false);
+    profiler.reset();
+  }
+
+  Profiler &profiler = Profiler::instance();
+};
+
+} // namespace
+
+TEST_F(ProfilerTest, CountsPhasesAndOperations) {
+  Interpreter interpreter;
+  std::ostringstream out;
+  std::ostringstream err;
+  Runner runner(interpreter, out, err);
+  runner.run("A = [1, 2; 3, 4];\nB = A * A;\nB + A - A\n");
+  ASSERT_EQ(err.str(), "");
+
+  using Phase = Profiler::Phase;
+  using Operation = Profiler::Operation;
+  EXPECT_EQ(profiler.phase(Phase::LEX).calls, 1);
+  EXPECT_EQ(profiler.phase(Phase::PARSE).calls, 1);
+  EXPECT_GT(profiler.phase(Phase::PARSE).bytes, 0);
+  EXPECT_EQ(profiler.phase(Phase::COMPILE).calls, 3);
+  EXPECT_EQ(profiler.phase(Phase::EVAL).calls, 3);
+  EXPECT_EQ(profiler.phase(Phase::PRINT).calls, 1);
+
+  // A 2x2 GEMM, and two element-wise operations over four elements.
+  EXPECT_EQ(profiler.operation(Operation::MULTIPLY).calls, 1);
+  EXPECT_EQ(profiler.operation(Operation::MULTIPLY).flops, 16);
+  EXPECT_EQ(profiler.operation(Operation::MULTIPLY).bytes,
+            4 * sizeof(double));
+  EXPECT_EQ(profiler.operation(Operation::ELEMENTWISE).flops, 8);
+
+  std::ostringstream json;
+  profiler.writeJson(json);
+  EXPECT_NE(json.str().find("\"multiply\": {\"calls\": 1,"),
+            std::string::npos);
+  std::ostringstream report;
+  profiler.report(report);
+  EXPECT_NE(report.str().find("elementwise"), std::string::npos);
+}
+
+TEST_F(ProfilerTest, DisabledProfilerRecordsNothing) {
+  profiler.setEnabled(false);
+  Interpreter interpreter;
+  interpreter.execute(*interpreter.compile("[1, 2] * [3; 4]"));
+  EXPECT_EQ(profiler.phase(Profiler::Phase::EVAL).calls, 0);
+  EXPECT_EQ(profiler.operation(Profiler::Operation::MULTIPLY).bytes, 0);
+
+  profiler.setEnabled(true);
+  interpreter.execute(*interpreter.compile("[1, 2] * [3; 4]"));
+  EXPECT_EQ(profiler.phase(Profiler::Phase::EVAL).calls, 1);
+  EXPECT_EQ(profiler.operation(Profiler::Operation::MULTIPLY).flops, 4);
+}
@@ -0,0 +1,85 @@
+#include "Runner.h"
+#include <gtest/gtest.h>
+#include <sstream>
+#include <string>
+
+class RunnerTest : public ::testing::Test {
+protected:
+  Interpreter interpreter;
+  std::ostringstream out;
+  std::ostringstream err;
+  Runner runner{interpreter, out, err};
+};
+
+TEST_F(RunnerTest, RunsStatementsInOrder) {
+  std::istringstream script(
+      "A = [1, 2;\n     3, 4];\nB = A * 2;\nB B\nB\n");
+  EXPECT_EQ(runner.run(script), 1);
+
+  EXPECT_EQ(interpreter.getVariable("B")(1, 1), 8);
+  EXPECT_EQ(out.str(), "       2       4\n       6       8\n\n");
+  EXPECT_EQ(err.str(), "Error on line 4: Expect end of statement.\n");
+}
+
+TEST_F(RunnerTest, ReportsErrorsAndContinues) {
+  std::istringstream script(
+      "x = 1;\ny = missing + 1;\nx += 2;\nx = [1, 2] + [1, 2, 3];\nx += 3;");
+  EXPECT_EQ(runner.run(script), 2);
+
+  EXPECT_EQ(interpreter.getVariable("x")(0, 0), 6);
+  EXPECT_EQ(err.str(), "Error on line 2: Undefined variable 'missing'.\n"
+                       "Error on line 4: Matrix dimensions must match for "
+                       "addition\n");
+}
+
+TEST_F(RunnerTest, LiteralSpanningBatches) {
+  // Statements and a literal larger than one read, so batches are cut at
+  // line ends outside the literal.
+  std::string script;
+  for (size_t i = 0; i < Runner::BATCH_BYTES / 8; ++i) {
+    script += "s = s + 1;\n";
+  }
+  script += "M = [";
+  for (size_t i = 0; i < Runner::BATCH_BYTES / 4; ++i) {
+    script += i % 4 == 3 ? "1\n" : "1, ";
+  }
+  script += "];\n$\n";
+  interpreter.setVariable("s", Matrix<double>{{0}});
+
+  std::istringstream in(script);
+  EXPECT_EQ(runner.run(in), 1);
+  EXPECT_EQ(interpreter.getVariable("s")(0, 0),
+            static_cast<double>(Runner::BATCH_BYTES / 8));
+  EXPECT_EQ(interpreter.getVariable("M").getRows(), Runner::BATCH_BYTES / 16);
+  EXPECT_EQ(interpreter.getVariable("M").getCols(), 4);
+  const size_t lastLine =
+      Runner::BATCH_BYTES / 8 + Runner::BATCH_BYTES / 16 + 2;
+  EXPECT_EQ(err.str(), "Error on line " + std::to_string(lastLine) +
+                           ": Unexpected character '$'.\n");
+}
+
+TEST_F(RunnerTest, BracketsInStringsAreIgnored) {
+  // A stream that records whether an error was reported by the time the
+  // Runner reaches its end.
+  struct Source : std::stringbuf {
+    const std::ostringstream &err;
+    bool reportedBeforeEnd = false;
+    Source(const std::string &text, const std::ostringstream &err)
+        : std::stringbuf(text), err(err) {}
+    auto xsgetn(char *s, std::streamsize n) -> std::streamsize override {
+      const std::streamsize read = std::stringbuf::xsgetn(s, n);
+      reportedBeforeEnd = reportedBeforeEnd || !err.str().empty();
+      return read;
+    }
+  };
+  std::string script = "x = 0;\nmissing(\"[\");\n";
+  for (size_t i = 0; i < Runner::BATCH_BYTES / 4; ++i) {
+    script += "x = x + 1;\n";
+  }
+  Source source(script, err);
+  std::istream in(&source);
+  EXPECT_EQ(runner.run(in), 1);
+  EXPECT_TRUE(source.reportedBeforeEnd);
+  EXPECT_EQ(interpreter.getVariable("x")(0, 0),
+            static_cast<double>(Runner::BATCH_BYTES / 4));
+}
@@ -0,0 +1,166 @@
+#include "Server.h"
+#include <gtest/gtest.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <thread>
+#include <unistd.h>
+
+namespace {
+
+/**
+ * @brief A server running on its own thread for the duration of a test.
+ */
+class ServerTest : public ::testing::Test {
+protected:
+  std::string path =
+      "/tmp/nl-server-test-" + std::to_string(::getpid()) + ".sock";
+  std::unique_ptr<Server> server;
+  std::thread thread;
+  std::vector<int> clients;
+
+  void start(ServerOptions options = {}) {
+    options.workers = 2;
+    server = std::make_unique<Server>(path, options);
+    thread = std::thread([this]() { server->run(); });
+  }
+
+  void TearDown() override {
+    for (const int fd : clients) {
+      ::close(fd);
+    }
+    if (server) {
+      server->stop();
+      thread.join();
+    }
+  }
+
+  auto connect() -> int {
+    const int fd = ::socket(AF_UNIX, SOCK_STREAM, 0);
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    path.copy(address.sun_path, sizeof(address.sun_path) - 1);
+    EXPECT_EQ(::connect(fd, reinterpret_cast<const sockaddr *>(&address),
+                        sizeof(address)),
+              0);
+    clients.push_back(fd);
+    return fd;
+  }
+
+  static void send(int fd, const std::string &data) {
+    ASSERT_EQ(::write(fd, data.data(), data.size()),
+              static_cast<ssize_t>(data.size()));
+  }
+
+  /**
+   * @brief Read one reply: its status and its payload.
+   */
+  static auto receive(int fd) -> std::pair<std::string, std::string> {
+    std::string header;
+    char c = 0;
+    while (::read(fd, &c, 1) == 1 && c != '\n') {
+      header += c;
+    }
+    const size_t space = header.find(' ');
+    if (space == std::string::npos) {
+      return {header, ""};
+    }
+    std::string payload(std::stoul(header.substr(space + 1)), '\0');
+    size_t received = 0;
+    while (received < payload.size()) {
+      const ssize_t n =
+          ::read(fd, &payload[received], payload.size() - received);
+      if (n <= 0) {
+        break;
+      }
+      received += static_cast<size_t>(n);
+    }
+    return {header.substr(0, space), payload};
+  }
+};
+
+} // namespace
+
+TEST_F(ServerTest, SessionsAreIndependent) {
+  start();
+  const int a = connect();
+  const int b = connect();
+
+  send(a, "x = [1, 2]; x * 2\n");
+  auto [status, payload] = receive(a);
+  EXPECT_EQ(status, "OK");
+  EXPECT_NE(payload.find('4'), std::string::npos);
+
+  send(b, "x\n");
+  std::tie(status, payload) = receive(b);
+  EXPECT_EQ(status, "ERR");
+  EXPECT_NE(payload.find("x"), std::string::npos);
+
+  send(b, "1 +\n");
+  EXPECT_EQ(receive(b).first, "ERR");
+  send(a, "x = x + 1;\n");
+  std::tie(status, payload) = receive(a);
+  EXPECT_EQ(status, "OK");
+  EXPECT_TRUE(payload.empty());
+}
+
+TEST_F(ServerTest, PipelinedRequestsRunInOrder) {
+  ServerOptions options;
+  options.maxPending = 1;
+  start(options);
+  const int fd = connect();
+
+  std::string requests = "n = 0;\n";
+  for (int i = 0; i < 50; ++i) {
+    requests += "n = n + 1;\n";
+  }
+  send(fd, requests + "n\n");
+  for (int i = 0; i < 51; ++i) {
+    ASSERT_EQ(receive(fd).first, "OK");
+  }
+  const auto [status, payload] = receive(fd);
+  EXPECT_EQ(status, "OK");
+  EXPECT_NE(payload.find("50"), std::string::npos);
+}
+
+TEST_F(ServerTest, RequestsTimeOut) {
+  ServerOptions options;
+  options.timeout = std::chrono::nanoseconds(1);
+  start(options);
+  const int fd = connect();
+
+  send(fd, "[1, 2] * [3; 4]\n");
+  const auto [status, payload] = receive(fd);
+  EXPECT_EQ(status, "ERR");
+  EXPECT_NE(payload.find("Time limit exceeded."), std::string::npos);
+}
+
+TEST_F(ServerTest, SessionsAreLimited) {
+  ServerOptions options;
+  options.maxSessions = 1;
+  start(options);
+  const int a = connect();
+  send(a, "1\n");
+  EXPECT_EQ(receive(a).first, "OK");
+
+  const int b = connect();
+  const auto [status, payload] = receive(b);
+  EXPECT_EQ(status, "ERR");
+  EXPECT_EQ(payload, "Too many sessions.\n");
+  EXPECT_EQ(server->sessionCount(), 1);
+}
+
+TEST_F(ServerTest, LongRequestsAreRejected) {
+  ServerOptions options;
+  options.maxRequestBytes = 1000;
+  start(options);
+  const int fd = connect();
+
+  send(fd, "x = 1;\n" + std::string(4000, ' '));
+  EXPECT_EQ(receive(fd).first, "OK");
+  const auto [status, payload] = receive(fd);
+  EXPECT_EQ(status, "ERR");
+  EXPECT_EQ(payload, "Request longer than 1000 bytes.\n");
+  // The session is closed.
+  char c = 0;
+  EXPECT_EQ(::read(fd, &c, 1), 0);
+}
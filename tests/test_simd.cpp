@@ -0,0 +1,66 @@
+#include "Matrix.h"
+#include "Simd.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+template <typename T> void expectAllLevelsMatchScalar(size_t n) {
+  std::vector<T> a(n);
+  std::vector<T> b(n);
+  for (size_t i = 0; i < n; ++i) {
+    a[i] = static_cast<T>(i % 23) - T(11);
+    b[i] = static_cast<T>(i % 7) + T(0.5);
+  }
+
+  const simd::Level previous = simd::level();
+  for (simd::Op op : {simd::Op::ADD, simd::Op::SUB, simd::Op::MUL}) {
+    simd::setLevel(simd::Level::SCALAR);
+    std::vector<T> expected(n);
+    simd::binary(op, a.data(), b.data(), expected.data(), n);
+    std::vector<T> expectedBroadcast(n);
+    simd::broadcast(op, a.data(), T(3), expectedBroadcast.data(), n);
+
+    for (simd::Level level :
+         {simd::Level::SSE2, simd::Level::AVX2, simd::Level::AVX512}) {
+      simd::setLevel(level);
+      for (size_t threshold : {size_t(0), simd::streamingThreshold()}) {
+        const size_t saved = simd::streamingThreshold();
+        simd::setStreamingThreshold(threshold);
+        // Offset by one element so the streaming path has to peel.
+        std::vector<T> out(n + 1);
+        simd::binary(op, a.data(), b.data(), out.data() + 1, n);
+        std::vector<T> outBroadcast(n + 1);
+        simd::broadcast(op, a.data(), T(3), outBroadcast.data() + 1, n);
+        simd::setStreamingThreshold(saved);
+
+        for (size_t i = 0; i < n; ++i) {
+          EXPECT_EQ(out[i + 1], expected[i]);
+          EXPECT_EQ(outBroadcast[i + 1], expectedBroadcast[i]);
+        }
+      }
+    }
+  }
+  simd::setLevel(previous);
+}
+
+} // namespace
+
+TEST(SimdTest, DoubleKernelsMatchScalar) {
+  expectAllLevelsMatchScalar<double>(131);
+}
+
+TEST(SimdTest, FloatKernelsMatchScalar) {
+  expectAllLevelsMatchScalar<float>(131);
+}
+
+TEST(SimdTest, InPlaceMatrixOperators) {
+  Matrix<double> m{{1, 2, 3}, {4, 5, 6}};
+  Matrix<double> other{{1, 1, 1}, {2, 2, 2}};
+  m += other;
+  EXPECT_EQ(m(1, 2), 8);
+  m -= other;
+  EXPECT_EQ(m(1, 2), 6);
+  m *= 2;
+  EXPECT_EQ(m(0, 1), 4);
+  EXPECT_THROW(m += Matrix<double>(3, 2), std::invalid_argument);
+}
@@ -0,0 +1,110 @@
+#include "SparseMatrix.h"
+#include "Value.h"
+#include <gtest/gtest.h>
+
+namespace {
+
+/**
+ * @brief A rows x cols matrix with roughly one nonzero in every stride
+ * elements.
+ */
+auto pattern(size_t rows, size_t cols, size_t stride) -> Matrix<double> {
+  Matrix<double> result(rows, cols);
+  for (size_t i = 0; i < result.size(); ++i) {
+    if ((i * 7) % stride == 0) {
+      result.raw()[i] = static_cast<double>(i % 9) - 4.0;
+    }
+  }
+  return result;
+}
+
+void expectEqual(const Matrix<double> &a, const Matrix<double> &b) {
+  ASSERT_EQ(a.getRows(), b.getRows());
+  ASSERT_EQ(a.getCols(), b.getCols());
+  for (size_t i = 0; i < a.size(); ++i) {
+    EXPECT_DOUBLE_EQ(a.raw()[i], b.raw()[i]);
+  }
+}
+
+} // namespace
+
+TEST(SparseMatrixTest, DenseRoundTrip) {
+  const Matrix<double> dense{{0, 2, 0}, {0, 0, 0}, {3, 0, 4}};
+  const auto sparse = SparseMatrix<double>::fromDense(dense);
+  EXPECT_EQ(sparse.getRows(), 3);
+  EXPECT_EQ(sparse.getCols(), 3);
+  EXPECT_EQ(sparse.nonZeros(), 3);
+  EXPECT_EQ(sparse.rowOffsets(), (std::vector<size_t>{0, 1, 1, 3}));
+  EXPECT_EQ(sparse.columnIndices(), (std::vector<size_t>{1, 0, 2}));
+  EXPECT_EQ(sparse(2, 2), 4);
+  EXPECT_EQ(sparse(1, 1), 0);
+  expectEqual(sparse.toDense(), dense);
+}
+
+TEST(SparseMatrixTest, InvalidStructure) {
+  EXPECT_THROW(SparseMatrix<double>(2, 2, {0, 1}, {0}, {1.0}),
+               std::invalid_argument);
+  EXPECT_THROW(SparseMatrix<double>(2, 2, {0, 1, 1}, {2}, {1.0}),
+               std::invalid_argument);
+  EXPECT_THROW(SparseMatrix<double>(1, 3, {0, 2}, {1, 0}, {1.0, 2.0}),
+               std::invalid_argument);
+}
+
+TEST(SparseMatrixTest, TransposeIsCompressedColumns) {
+  const Matrix<double> dense = pattern(37, 23, 5);
+  const auto transposed = SparseMatrix<double>::fromDense(dense).transpose();
+  ASSERT_EQ(transposed.getRows(), 23);
+  ASSERT_EQ(transposed.getCols(), 37);
+  for (size_t i = 0; i < dense.getRows(); ++i) {
+    for (size_t j = 0; j < dense.getCols(); ++j) {
+      EXPECT_EQ(transposed(j, i), dense(i, j));
+    }
+  }
+}
+
+TEST(SparseMatrixTest, ProductsMatchDense) {
+  // Large enough to split the rows across the pool.
+  const Matrix<double> a = pattern(301, 257, 11);
+  const Matrix<double> b = pattern(257, 199, 13);
+  const auto sa = SparseMatrix<double>::fromDense(a);
+  const auto sb = SparseMatrix<double>::fromDense(b);
+  const Matrix<double> expected = a * b;
+
+  expectEqual(sa * b, expected);
+  expectEqual(a * sb, expected);
+  expectEqual((sa * sb).toDense(), expected);
+
+  const Matrix<double> x = pattern(257, 1, 1);
+  expectEqual(sa * x, a * x);
+  EXPECT_THROW(sa * sa, std::invalid_argument);
+}
+
+TEST(SparseMatrixTest, AdditionAndSubtraction) {
+  const Matrix<double> a = pattern(64, 48, 3);
+  const Matrix<double> b = pattern(64, 48, 4);
+  const auto sa = SparseMatrix<double>::fromDense(a);
+  const auto sb = SparseMatrix<double>::fromDense(b);
+  expectEqual((sa + sb).toDense(), a + b);
+  expectEqual((sa - sb).toDense(), a - b);
+  expectEqual((sa * 2.0).toDense(), a * 2.0);
+  // The pattern is the union of both; cancelled entries stay stored.
+  EXPECT_EQ((sa - sa).nonZeros(), sa.nonZeros());
+  EXPECT_EQ((sa + sb).nonZeros(),
+            SparseMatrix<double>::fromDense(a + b).nonZeros());
+  EXPECT_THROW(sa + sa.transpose(), std::invalid_argument);
+}
+
+TEST(SparseMatrixTest, FilledResultIsDensified) {
+  const Matrix<double> column{{1}, {2}, {3}};
+  const Matrix<double> row{{4, 5, 6}};
+  const Value a = SparseMatrix<double>::fromDense(column);
+  const Value b = SparseMatrix<double>::fromDense(row);
+  const Value outer = multiply(a, b, gemm::Algorithm::STANDARD);
+  EXPECT_FALSE(outer.isSparse());
+  EXPECT_EQ(outer(2, 2), 18);
+
+  const Value sparse = SparseMatrix<double>::fromDense(pattern(50, 50, 10));
+  EXPECT_TRUE(add(sparse, sparse, false).isSparse());
+  EXPECT_TRUE(scale(sparse, 3.0).isSparse());
+  EXPECT_FALSE(add(sparse, pattern(50, 50, 1), false).isSparse());
+}
@@ -0,0 +1,86 @@
+#include "Matrix.h"
+#include "ThreadPool.h"
+#include <atomic>
+#include <chrono>
+#include <ctime>
+#include <gtest/gtest.h>
+
+TEST(ThreadPoolTest, ParallelForVisitsEveryIndexOnce) {
+  ThreadPool pool(4);
+  std::vector<std::atomic<int>> hits(1000);
+  pool.parallelFor(hits.size(), [&](size_t i) { ++hits[i]; });
+  for (const auto &hit : hits) {
+    EXPECT_EQ(hit, 1);
+  }
+}
+
+TEST(ThreadPoolTest, NestedParallelFor) {
+  ThreadPool pool(2);
+  std::atomic<int> total{0};
+  pool.parallelFor(4, [&](size_t) {
+    pool.parallelFor(8, [&](size_t) { ++total; });
+  });
+  EXPECT_EQ(total, 32);
+}
+
+TEST(ThreadPoolTest, ExceptionsPropagate) {
+  ThreadPool pool(3);
+  EXPECT_THROW(pool.parallelFor(16,
+                                [](size_t i) {
+                                  if (i == 7) {
+                                    throw std::runtime_error("boom");
+                                  }
+                                }),
+               std::runtime_error);
+}
+
+TEST(ThreadPoolTest, ParallelMultiplicationMatchesSerial) {
+  ThreadPool &pool = ThreadPool::instance();
+  const size_t previous = pool.threadCount();
+
+  const size_t n = 257;
+  Matrix<double> a(n, n);
+  Matrix<double> b(n, n);
+  for (size_t i = 0; i < a.size(); ++i) {
+    a.raw()[i] = static_cast<double>(i % 17) - 8.0;
+    b.raw()[i] = static_cast<double>(i % 19) - 9.0;
+  }
+  pool.setThreadCount(1);
+  Matrix<double> serial = a * b;
+  pool.setThreadCount(4);
+  Matrix<double> parallel = a * b;
+  pool.setThreadCount(previous);
+
+  for (size_t i = 0; i < serial.size(); ++i) {
+    EXPECT_EQ(parallel.raw()[i], serial.raw()[i]);
+  }
+}
+
+TEST(ThreadPoolTest, WaitingWorkerSleeps) {
+  // The worker calling parallelFor() finishes its index first and then
+  // waits for the other worker's slow one; it must not spin meanwhile.
+  ThreadPool pool(2);
+  std::atomic<bool> started{false};
+  std::atomic<bool> finished{false};
+  const std::clock_t start = std::clock();
+  pool.submit([&]() {
+    const std::thread::id caller = std::this_thread::get_id();
+    pool.parallelFor(2, [&](size_t) {
+      if (std::this_thread::get_id() != caller) {
+        started = true;
+        std::this_thread::sleep_for(std::chrono::milliseconds(300));
+        return;
+      }
+      while (!started) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+      }
+    });
+    finished = true;
+  });
+  while (!finished) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  }
+  const double seconds =
+      static_cast<double>(std::clock() - start) / CLOCKS_PER_SEC;
+  EXPECT_LT(seconds, 0.15);
+}
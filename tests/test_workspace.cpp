@@ -0,0 +1,180 @@
+#include "Interpreter.h"
+#include "Workspace.h"
+#include <cstdint>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <utility>
+
+namespace {
+
+auto tempPath(const std::string &name) -> std::string {
+  return ::testing::TempDir() + name;
+}
+
+auto run(Interpreter &interpreter, const std::string &source)
+    -> Matrix<double> {
+  return interpreter.execute(*interpreter.compile(source));
+}
+
+} // namespace
+
+TEST(WorkspaceTest, RoundTripIncludesAns) {
+  const std::string path = tempPath("round_trip.nlws");
+  {
+    Interpreter interpreter;
+    Matrix<double> large(65, 3);
+    for (size_t i = 0; i < large.size(); ++i) {
+      large.raw()[i] = static_cast<double>(i);
+    }
+    interpreter.setVariable("Large", large);
+    interpreter.setVariable("Empty", Matrix<double>(0, 0));
+    run(interpreter, "A = [1, 2; 3, 4]");
+    run(interpreter, "A * 10");
+    interpreter.saveWorkspace(path);
+  }
+
+  Interpreter interpreter;
+  interpreter.loadWorkspace(path);
+  EXPECT_EQ(interpreter.getVariable("ans")(1, 1), 40);
+  EXPECT_EQ(interpreter.getVariable("A")(0, 1), 2);
+  EXPECT_EQ(interpreter.getVariable("Empty").size(), 0);
+  Matrix<double> large = interpreter.getVariable("Large");
+  ASSERT_EQ(large.getRows(), 65);
+  ASSERT_EQ(large.getCols(), 3);
+  const double *data = std::as_const(large).raw();
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(data) % MATRIX_ALIGNMENT, 0);
+  EXPECT_EQ(data[194], 194);
+  EXPECT_THROW(interpreter.getVariable("B"), std::runtime_error);
+}
+
+TEST(WorkspaceTest, StoredVariablesBehaveLikeVariables) {
+  const std::string path = tempPath("stored.nlws");
+  {
+    Interpreter interpreter;
+    run(interpreter, "A = [1, 2]");
+    run(interpreter, "B = [3, 4]");
+    run(interpreter, "C = [5, 6]");
+    interpreter.saveWorkspace(path);
+  }
+
+  Interpreter interpreter;
+  run(interpreter, "A = [9, 9]");
+  interpreter.loadWorkspace(path);
+  EXPECT_EQ(interpreter.getVariable("A")(0, 0), 1);
+
+  // Overwriting or updating a variable that was never touched.
+  run(interpreter, "B = [7, 8]");
+  run(interpreter, "C += [1, 1]");
+  EXPECT_EQ(interpreter.getVariable("B")(0, 1), 8);
+  EXPECT_EQ(interpreter.getVariable("C")(0, 1), 7);
+
+  // Saving over the mapped snapshot keeps its matrices valid.
+  interpreter.saveWorkspace(path);
+  EXPECT_EQ(interpreter.getVariable("A")(0, 1), 2);
+  Interpreter restored;
+  restored.loadWorkspace(path);
+  EXPECT_EQ(restored.getVariable("C")(0, 0), 6);
+}
+
+TEST(WorkspaceTest, RejectsInvalidFiles) {
+  Interpreter interpreter;
+  EXPECT_THROW(interpreter.loadWorkspace(tempPath("missing.nlws")),
+               std::runtime_error);
+
+  const std::string path = tempPath("invalid.nlws");
+  std::ofstream(path) << "not a workspace file";
+  EXPECT_THROW(interpreter.loadWorkspace(path), std::runtime_error);
+
+  // An index entry pointing past the variables.
+  const Value a = Matrix<double>(2, 2);
+  saveWorkspace(path, {{"A", &a}});
+  std::ofstream(path, std::ios::binary | std::ios::in | std::ios::out)
+      .seekp(193)
+      .put(1);
+  EXPECT_THROW(interpreter.loadWorkspace(path), std::runtime_error);
+}
+
+TEST(WorkspaceTest, SaveAndLoadBuiltins) {
+  const std::string path = tempPath("builtins.nlws");
+  Interpreter interpreter;
+  run(interpreter, "A = [1, 2; 3, 4]");
+  run(interpreter, "5");
+  run(interpreter, "savews(\"" + path + "\")");
+  EXPECT_EQ(interpreter.getVariable("ans")(0, 0), 5);
+
+  Interpreter restored;
+  run(restored, "loadws(\"" + path + "\")");
+  EXPECT_EQ(run(restored, "A * ans")(1, 0), 15);
+
+  EXPECT_THROW(run(restored, "savews(A)"), std::runtime_error);
+  EXPECT_THROW(run(restored, "loadws()"), std::runtime_error);
+}
+
+TEST(WorkspaceTest, TracksModifications) {
+  const std::string path = tempPath("modified.nlws");
+  {
+    Interpreter interpreter;
+    run(interpreter, "A = [1, 2]");
+    interpreter.saveWorkspace(path);
+  }
+
+  Interpreter interpreter;
+  interpreter.loadWorkspace(path);
+  EXPECT_EQ(interpreter.getVariable("A")(0, 1), 2);
+  run(interpreter, "savews(\"" + tempPath("copy.nlws") + "\")");
+  EXPECT_FALSE(interpreter.isModified());
+  run(interpreter, "A += 1");
+  EXPECT_TRUE(interpreter.isModified());
+
+  Interpreter other;
+  run(other, "loadws(\"" + path + "\")");
+  EXPECT_TRUE(other.isModified());
+  Interpreter assigned;
+  assigned.setVariable("B", 1.0);
+  EXPECT_TRUE(assigned.isModified());
+}
+
+TEST(WorkspaceTest, KeepsElementTypes) {
+  const std::string path = tempPath("types.nlws");
+  {
+    Interpreter interpreter;
+    run(interpreter, "A = int32([2147483647, 1])");
+    run(interpreter, "F = single([0.5, 1.5])");
+    run(interpreter, "x = 2");
+    interpreter.saveWorkspace(path);
+  }
+
+  Interpreter interpreter;
+  interpreter.loadWorkspace(path);
+  EXPECT_EQ(interpreter.getVariable("A").dtype(), DType::INT32);
+  EXPECT_EQ(run(interpreter, "A + A")(0, 0), -2);
+  EXPECT_EQ(interpreter.getVariable("F").dtype(), DType::FLOAT32);
+  EXPECT_EQ(interpreter.getVariable("F")(0, 1), 1.5);
+  EXPECT_TRUE(interpreter.getVariable("x").isScalar());
+}
+
+TEST(WorkspaceTest, SparseVariablesStaySparse) {
+  const std::string path = tempPath("sparse.nlws");
+  {
+    Interpreter interpreter;
+    Matrix<double> identity(500, 500);
+    for (size_t i = 0; i < 500; ++i) {
+      identity(i, i) = 1;
+    }
+    interpreter.setVariable("I", identity);
+    run(interpreter, "S = sparse(I) * 3;");
+    interpreter.setVariable("I", Matrix<double>());
+    interpreter.saveWorkspace(path);
+  }
+  EXPECT_LT(std::ifstream(path, std::ios::binary | std::ios::ate).tellg(),
+            64 * 1024);
+
+  Interpreter interpreter;
+  interpreter.loadWorkspace(path);
+  const Value s = interpreter.getVariable("S");
+  ASSERT_TRUE(s.isSparse());
+  EXPECT_EQ(s.sparse().nonZeros(), 500);
+  EXPECT_EQ(s(499, 499), 3);
+  EXPECT_EQ(s(0, 1), 0);
+}